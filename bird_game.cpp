@@ -1,5 +1,17 @@
 #include "include/raylib.h"
+#include "include/worker_pool.h"
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -13,6 +25,9 @@ const float GRAVITY = 950.0f;
 const float JUMP_FORCE = -330.0f;
 const float PIPE_SPEED = 210.0f;
 const int PIPE_GAP = 185;
+const float PIPE_WIDTH = 60.0f;
+const float BIRD_X = 100.0f;
+const float BIRD_RADIUS = 14.0f;   // 碰撞半径，略小于绘制半径
 
 struct Pipe {
     float x;
@@ -20,20 +35,894 @@ struct Pipe {
     bool passed;
 };
 
+// --- 定长管道环形队列：生成和回收都是 O(1)，帧循环里没有内存分配 ---
+const int PIPE_CAPACITY = 16;
+
+struct PipeRing {
+    Pipe items[PIPE_CAPACITY];
+    int head = 0;    // 最老（最靠左）的管道
+    int count = 0;
+
+    Pipe& operator[](int i) { return items[(head + i) % PIPE_CAPACITY]; }
+    const Pipe& operator[](int i) const { return items[(head + i) % PIPE_CAPACITY]; }
+    void Clear() { head = 0; count = 0; }
+    void Push(const Pipe& p) {
+        if (count == PIPE_CAPACITY) PopFront(); // 满了就丢弃最老的一根，正常参数下不会发生
+        items[(head + count) % PIPE_CAPACITY] = p;
+        count++;
+    }
+    void PopFront() {
+        head = (head + 1) % PIPE_CAPACITY;
+        count--;
+    }
+};
+
+// --- 赛道：由种子决定的管道流，游戏和无头训练共用同一套推进逻辑 ---
+struct Course {
+    PipeRing pipes;
+    float pipeTimer = 0;
+    uint32_t rng = 1;
+    int passed = 0;
+};
+
+void ResetCourse(Course& c, uint32_t seed) {
+    c.pipes.Clear();
+    c.pipeTimer = 0;
+    c.rng = seed ? seed : 1;
+    c.passed = 0;
+}
+
+uint32_t NextCourseRandom(Course& c) {
+    // xorshift32
+    c.rng ^= c.rng << 13;
+    c.rng ^= c.rng >> 17;
+    c.rng ^= c.rng << 5;
+    return c.rng;
+}
+
+// 生成、平移、计分、回收，返回本步新越过的管道数
+int StepCourse(Course& c, float dt) {
+    c.pipeTimer += dt;
+    if (c.pipeTimer > 2.2f) {
+        c.pipes.Push({ (float)SCREEN_WIDTH, (float)(100 + NextCourseRandom(c) % 251), false });
+        c.pipeTimer = 0;
+    }
+
+    int newlyPassed = 0;
+    for (int i = 0; i < c.pipes.count; i++) {
+        c.pipes[i].x -= PIPE_SPEED * dt;
+        if (!c.pipes[i].passed && c.pipes[i].x < BIRD_X) {
+            c.pipes[i].passed = true;
+            newlyPassed++;
+        }
+    }
+    if (c.pipes.count > 0 && c.pipes[0].x < -100) c.pipes.PopFront();
+    c.passed += newlyPassed;
+    return newlyPassed;
+}
+
+// 管道按 x 递增排列，横向还可能碰到小鸟的第一根就是最近的一根
+const Pipe* NearestPipe(const Course& c) {
+    for (int i = 0; i < c.pipes.count; i++) {
+        const Pipe& p = c.pipes[i];
+        if (p.x + PIPE_WIDTH + BIRD_RADIUS >= BIRD_X) return &p;
+    }
+    return nullptr;
+}
+
+// 圆与上下两段管道的最近点距离判定，与 CheckCollisionCircleRec 等价；只看步末位置
+bool BirdHitsPipe(float y, const Pipe& p) {
+    float dx = fmaxf(fmaxf(p.x - BIRD_X, BIRD_X - (p.x + PIPE_WIDTH)), 0.0f);
+    if (dx > BIRD_RADIUS) return false;
+    float bottomTop = p.topHeight + PIPE_GAP;
+    float dyTop = fmaxf(y - p.topHeight, 0.0f);
+    float dyBottom = fmaxf(bottomTop - y, 0.0f);
+    float r2 = BIRD_RADIUS * BIRD_RADIUS;
+    return dx * dx + dyTop * dyTop <= r2 || dx * dx + dyBottom * dyBottom <= r2;
+}
+
+// --- 扫掠圆碰撞：把一步内小鸟相对管道走过的线段，和按半径外扩的管道做距离判定 ---
+float PointRectDistSq(float px, float py, Rectangle r) {
+    float dx = fmaxf(fmaxf(r.x - px, px - (r.x + r.width)), 0.0f);
+    float dy = fmaxf(fmaxf(r.y - py, py - (r.y + r.height)), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+float PointSegmentDistSq(float px, float py, float x0, float y0, float x1, float y1) {
+    float sx = x1 - x0, sy = y1 - y0;
+    float len2 = sx * sx + sy * sy;
+    float t = (len2 > 0) ? ((px - x0) * sx + (py - y0) * sy) / len2 : 0.0f;
+    t = fminf(fmaxf(t, 0.0f), 1.0f);
+    float dx = x0 + sx * t - px, dy = y0 + sy * t - py;
+    return dx * dx + dy * dy;
+}
+
+// Liang-Barsky 裁剪：线段是否穿过矩形
+bool SegmentCrossesRect(float x0, float y0, float x1, float y1, Rectangle r) {
+    float t0 = 0.0f, t1 = 1.0f;
+    float d[2] = { x1 - x0, y1 - y0 };
+    float lo[2] = { r.x - x0, r.y - y0 };
+    float hi[2] = { r.x + r.width - x0, r.y + r.height - y0 };
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0) {
+            if (lo[axis] > 0 || hi[axis] < 0) return false;
+            continue;
+        }
+        float a = lo[axis] / d[axis], b = hi[axis] / d[axis];
+        if (a > b) { float tmp = a; a = b; b = tmp; }
+        t0 = fmaxf(t0, a);
+        t1 = fminf(t1, b);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+
+// 二维里线段与凸多边形不相交时，最近距离一定落在某一方的顶点上
+bool SegmentHitsRect(float x0, float y0, float x1, float y1, Rectangle r, float radius) {
+    if (SegmentCrossesRect(x0, y0, x1, y1, r)) return true;
+    float r2 = radius * radius;
+    if (PointRectDistSq(x0, y0, r) <= r2 || PointRectDistSq(x1, y1, r) <= r2) return true;
+    const float cx[2] = { r.x, r.x + r.width }, cy[2] = { r.y, r.y + r.height };
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            if (PointSegmentDistSq(cx[i], cy[j], x0, y0, x1, y1) <= r2) return true;
+        }
+    }
+    return false;
+}
+
+void PipeRects(const Pipe& p, Rectangle& top, Rectangle& bottom) {
+    const float FAR = 1e6f;
+    top = { p.x, -FAR, PIPE_WIDTH, p.topHeight + FAR };
+    bottom = { p.x, p.topHeight + PIPE_GAP, PIPE_WIDTH, FAR };
+}
+
+// 以步末的管道为参照系：小鸟从 (BIRD_X - PIPE_SPEED * dt, y0) 扫到 (BIRD_X, y1)
+// 上下两段管道都视为向屏幕外无限延伸，与 BirdHitsPipe 一致
+bool SweptBirdHitsPipe(float y0, float y1, float dt, const Pipe& p) {
+    const float x0 = BIRD_X - PIPE_SPEED * dt;
+    // 早退：横向够不着，或整条轨迹连同半径都在缺口内
+    if (x0 - BIRD_RADIUS > p.x + PIPE_WIDTH || BIRD_X + BIRD_RADIUS < p.x) return false;
+    float minY = fminf(y0, y1), maxY = fmaxf(y0, y1);
+    if (minY - BIRD_RADIUS > p.topHeight && maxY + BIRD_RADIUS < p.topHeight + PIPE_GAP) return false;
+
+    Rectangle top, bottom;
+    PipeRects(p, top, bottom);
+    return SegmentHitsRect(x0, y0, BIRD_X, y1, top, BIRD_RADIUS) || SegmentHitsRect(x0, y0, BIRD_X, y1, bottom, BIRD_RADIUS);
+}
+
+// 管道按 x 递增排列：已经完全落在轨迹左侧的跳过，越过轨迹右侧的第一根之后全部不用看
+bool SweptBirdHits(const Course& c, float y0, float y1, float dt) {
+    const float minX = BIRD_X - PIPE_SPEED * dt - BIRD_RADIUS;
+    for (int i = 0; i < c.pipes.count; i++) {
+        const Pipe& p = c.pipes[i];
+        if (p.x > BIRD_X + BIRD_RADIUS) break;
+        if (p.x + PIPE_WIDTH < minX) continue;
+        if (SweptBirdHitsPipe(y0, y1, dt, p)) return true;
+    }
+    return false;
+}
+
+// --- 小鸟控制器：4 输入 (相对缺口中心的高度, 速度, 到管道的水平距离, 偏置) -> 6 隐层 -> 是否拍翅 ---
+const int NN_INPUTS = 4;
+const int NN_HIDDEN = 6;
+const int GENOME_SIZE = NN_HIDDEN * NN_INPUTS + NN_HIDDEN + 1;
+
+// 没有管道时假装前方屏幕边缘有一根居中的
+void PipeInputs(const Pipe* p, float& gapCenter, float& dxNorm) {
+    float top = p ? p->topHeight : (SCREEN_HEIGHT - PIPE_GAP) / 2.0f;
+    float x = p ? p->x : (float)SCREEN_WIDTH;
+    gapCenter = top + PIPE_GAP / 2.0f;
+    dxNorm = (x - BIRD_X) / SCREEN_WIDTH;
+}
+
+// 标量版本，用于渲染模式；与下方 SIMD 批量版本的计算顺序一致
+bool GenomeWantsFlap(const float* g, float y, float vel, const Pipe* p) {
+    float gapCenter, dxNorm;
+    PipeInputs(p, gapCenter, dxNorm);
+    float in0 = (y - gapCenter) * (1.0f / SCREEN_HEIGHT);
+    float in1 = vel * 0.001f;
+    float out = g[GENOME_SIZE - 1];
+    for (int j = 0; j < NN_HIDDEN; j++) {
+        float h = g[j * NN_INPUTS + 0] * in0 + g[j * NN_INPUTS + 1] * in1 + g[j * NN_INPUTS + 2] * dxNorm + g[j * NN_INPUTS + 3];
+        h = h / (1.0f + fabsf(h));
+        out += g[NN_HIDDEN * NN_INPUTS + j] * h;
+    }
+    return out > 0;
+}
+
+// --- 固定步长物理：240Hz 子步，同样的输入序列总是得到同样的轨迹，与帧率无关 ---
+const float PHYSICS_DT = 1.0f / 240.0f;
+const float MAX_FRAME_TIME = 0.25f;   // 单帧最多补 60 个子步，防止卡顿后雪崩
+
 float birdY = 300.0f;
 float birdVelocity = 0.0f;
-std::vector<Pipe> pipes;
+float prevBirdY = 300.0f;     // 上一子步的位置，用于渲染插值
+float physicsAccumulator = 0;
+bool pendingFlap = false;     // 帧内采样到的拍翅，留给下一个子步
+Course course;
 int score = 0;
 bool isGameOver = false;
-float pipeTimer = 0;
+bool aiPlaying = false;       // --watch 载入基因组后由网络代替玩家拍翅
+float aiGenome[GENOME_SIZE];
 
 void ResetGame() {
     birdY = 300.0f;
     birdVelocity = 0.0f;
-    pipes.clear();
+    prevBirdY = birdY;
+    physicsAccumulator = 0;
+    pendingFlap = false;
+    ResetCourse(course, (uint32_t)GetRandomValue(1, 0x7FFFFFFF));
     score = 0;
     isGameOver = false;
-    pipeTimer = 0;
+}
+
+// --- 4 路浮点 SIMD：原生 SSE，wasm 上用 simd128，都没有时退回标量 ---
+// 掩码只由比较产生、只交给 And/Or/Select/Bits 使用
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+typedef __m128 F4;
+inline F4 F4Set(float v) { return _mm_set1_ps(v); }
+inline F4 F4Load(const float* p) { return _mm_loadu_ps(p); }
+inline void F4Store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 F4Add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 F4Sub(F4 a, F4 b) { return _mm_sub_ps(a, b); }
+inline F4 F4Mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+inline F4 F4Div(F4 a, F4 b) { return _mm_div_ps(a, b); }
+inline F4 F4Max(F4 a, F4 b) { return _mm_max_ps(a, b); }
+inline F4 F4Abs(F4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline F4 F4Less(F4 a, F4 b) { return _mm_cmplt_ps(a, b); }
+inline F4 F4LessEq(F4 a, F4 b) { return _mm_cmple_ps(a, b); }
+inline F4 F4Or(F4 a, F4 b) { return _mm_or_ps(a, b); }
+inline F4 F4Select(F4 mask, F4 a, F4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline int F4Bits(F4 mask) { return _mm_movemask_ps(mask); }
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+typedef v128_t F4;
+inline F4 F4Set(float v) { return wasm_f32x4_splat(v); }
+inline F4 F4Load(const float* p) { return wasm_v128_load(p); }
+inline void F4Store(float* p, F4 v) { wasm_v128_store(p, v); }
+inline F4 F4Add(F4 a, F4 b) { return wasm_f32x4_add(a, b); }
+inline F4 F4Sub(F4 a, F4 b) { return wasm_f32x4_sub(a, b); }
+inline F4 F4Mul(F4 a, F4 b) { return wasm_f32x4_mul(a, b); }
+inline F4 F4Div(F4 a, F4 b) { return wasm_f32x4_div(a, b); }
+inline F4 F4Max(F4 a, F4 b) { return wasm_f32x4_pmax(a, b); }
+inline F4 F4Abs(F4 a) { return wasm_f32x4_abs(a); }
+inline F4 F4Less(F4 a, F4 b) { return wasm_f32x4_lt(a, b); }
+inline F4 F4LessEq(F4 a, F4 b) { return wasm_f32x4_le(a, b); }
+inline F4 F4Or(F4 a, F4 b) { return wasm_v128_or(a, b); }
+inline F4 F4Select(F4 mask, F4 a, F4 b) { return wasm_v128_bitselect(a, b, mask); }
+inline int F4Bits(F4 mask) { return (int)wasm_i32x4_bitmask(mask); }
+#else
+struct F4 { float v[4]; };
+#define F4_MAP(expr) F4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+inline F4 F4Set(float v) { F4_MAP(v); }
+inline F4 F4Load(const float* p) { F4_MAP(p[i]); }
+inline void F4Store(float* p, F4 v) { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+inline F4 F4Add(F4 a, F4 b) { F4_MAP(a.v[i] + b.v[i]); }
+inline F4 F4Sub(F4 a, F4 b) { F4_MAP(a.v[i] - b.v[i]); }
+inline F4 F4Mul(F4 a, F4 b) { F4_MAP(a.v[i] * b.v[i]); }
+inline F4 F4Div(F4 a, F4 b) { F4_MAP(a.v[i] / b.v[i]); }
+inline F4 F4Max(F4 a, F4 b) { F4_MAP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+inline F4 F4Abs(F4 a) { F4_MAP(fabsf(a.v[i])); }
+inline F4 F4Less(F4 a, F4 b) { F4_MAP(a.v[i] < b.v[i] ? 1.0f : 0.0f); }
+inline F4 F4LessEq(F4 a, F4 b) { F4_MAP(a.v[i] <= b.v[i] ? 1.0f : 0.0f); }
+inline F4 F4Or(F4 a, F4 b) { F4_MAP((a.v[i] != 0 || b.v[i] != 0) ? 1.0f : 0.0f); }
+inline F4 F4Select(F4 mask, F4 a, F4 b) { F4_MAP(mask.v[i] != 0 ? a.v[i] : b.v[i]); }
+inline int F4Bits(F4 mask) { int bits = 0; for (int i = 0; i < 4; i++) if (mask.v[i] != 0) bits |= 1 << i; return bits; }
+#undef F4_MAP
+#endif
+
+// --- 无头神经进化训练：结构数组存放种群，4 只一组 SIMD 推进，各线程各跑一段种群 ---
+const int TRAIN_MAX_STEPS = 240 * 120;  // 每代最多模拟两分钟
+
+struct Population {
+    int size = 0;                 // 4 的倍数
+    std::vector<float> weights;   // weights[k * size + b]：同一权重的所有个体连续存放
+    std::vector<float> next;      // 下一代的权重
+    std::vector<float> y, vel;
+    std::vector<float> fitness;
+    std::vector<int> score;
+};
+
+uint32_t HashSeed(uint32_t a, uint32_t b) {
+    uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u + (a << 6) + (a >> 2));
+    h ^= h >> 16; h *= 0x85EBCA6Bu; h ^= h >> 13; h *= 0xC2B2AE35u; h ^= h >> 16;
+    return h ? h : 1;
+}
+
+float RandomUnit(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+// 常驻线程池（include/worker_pool.h）：训练每代、求解各种子都复用同一批线程。
+// 线程数由命令行指定，只在和上次不同时重建；Web 端单线程
+WorkerPool& GetBirdPool(int threads) {
+#if defined(PLATFORM_WEB)
+    threads = 1;
+#endif
+    static std::unique_ptr<WorkerPool> pool;
+    if (!pool || pool->ThreadCount() != threads) pool.reset(new WorkerPool(threads));
+    return *pool;
+}
+
+// 把 [0, count) 切成 4 对齐的若干段交给线程池
+void ParallelFor(int count, int threads, const std::function<void(int, int)>& fn) {
+    if (threads <= 1 || count <= 4) {
+        fn(0, count);
+        return;
+    }
+    int per = ((count + threads - 1) / threads + 3) & ~3;
+    GetBirdPool(threads).Run((count + per - 1) / per, [&](int t) { fn(t * per, std::min(count, t * per + per)); });
+}
+
+void InitPopulation(Population& pop, int size, uint32_t seed) {
+    pop.size = (size + 3) & ~3;
+    pop.weights.resize((size_t)GENOME_SIZE * pop.size);
+    pop.next.resize(pop.weights.size());
+    pop.y.resize(pop.size);
+    pop.vel.resize(pop.size);
+    pop.fitness.resize(pop.size);
+    pop.score.resize(pop.size);
+    uint32_t rng = seed;
+    for (float& w : pop.weights) w = RandomUnit(rng) * 2.0f - 1.0f;
+}
+
+// 模拟 [begin, end) 这段个体跑完一局；赛道由种子决定，每段各自推进一份副本，结果完全一致
+long long SimulateRange(Population& pop, int begin, int end, uint32_t courseSeed) {
+    Course c;
+    ResetCourse(c, courseSeed);
+    const int groups = (end - begin) / 4;
+    std::vector<uint8_t> aliveBits(groups, 0xF);
+    int aliveGroups = groups;
+    long long steps = 0;
+
+    for (int b = begin; b < end; b++) {
+        pop.y[b] = 300.0f;
+        pop.vel[b] = 0.0f;
+    }
+
+    const F4 zero = F4Set(0.0f), one = F4Set(1.0f);
+    const F4 jump = F4Set(JUMP_FORCE), gdt = F4Set(GRAVITY * PHYSICS_DT), dt = F4Set(PHYSICS_DT);
+    const F4 height = F4Set((float)SCREEN_HEIGHT);
+    const float* w = pop.weights.data();
+    const size_t stride = pop.size;
+
+    for (int step = 0; step < TRAIN_MAX_STEPS && aliveGroups > 0; step++) {
+        // 网络看到的是推进前的管道，碰撞用推进后的管道，与游戏帧内顺序一致
+        float gapCenter, dxNorm;
+        PipeInputs(NearestPipe(c), gapCenter, dxNorm);
+        StepCourse(c, PHYSICS_DT);
+        // 与 SweptBirdHits 同样的横向范围：这一步扫掠轨迹够得着任何一根管道时才逐只做扫掠判定
+        bool pipeInReach = false;
+        for (int i = 0; i < c.pipes.count && !pipeInReach; i++) {
+            const Pipe& p = c.pipes[i];
+            if (p.x > BIRD_X + BIRD_RADIUS) break;
+            pipeInReach = p.x + PIPE_WIDTH >= BIRD_X - PIPE_SPEED * PHYSICS_DT - BIRD_RADIUS;
+        }
+        const F4 gapV = F4Set(gapCenter), dxV = F4Set(dxNorm);
+
+        for (int g = 0; g < groups; g++) {
+            if (!aliveBits[g]) continue;
+            const int b = begin + g * 4;
+            F4 y0 = F4Load(&pop.y[b]);
+            F4 y = y0;
+            F4 vel = F4Load(&pop.vel[b]);
+
+            // 批量前向：每个权重一次装入 4 只鸟各自的值
+            F4 in0 = F4Mul(F4Sub(y, gapV), F4Set(1.0f / SCREEN_HEIGHT));
+            F4 in1 = F4Mul(vel, F4Set(0.001f));
+            F4 out = F4Load(w + (GENOME_SIZE - 1) * stride + b);
+            for (int j = 0; j < NN_HIDDEN; j++) {
+                const float* wj = w + (size_t)(j * NN_INPUTS) * stride + b;
+                F4 h = F4Add(F4Add(F4Add(F4Mul(F4Load(wj), in0), F4Mul(F4Load(wj + stride), in1)),
+                                   F4Mul(F4Load(wj + 2 * stride), dxV)), F4Load(wj + 3 * stride));
+                h = F4Div(h, F4Add(one, F4Abs(h)));
+                out = F4Add(out, F4Mul(F4Load(w + (size_t)(NN_HIDDEN * NN_INPUTS + j) * stride + b), h));
+            }
+
+            vel = F4Select(F4Less(zero, out), jump, vel);
+            vel = F4Add(vel, gdt);
+            y = F4Add(y, F4Mul(vel, dt));
+
+            F4 dead = F4Or(F4Less(height, y), F4Less(y, zero));
+
+            // 已死的个体保持原状态不再写回
+            int alive = aliveBits[g];
+            int died = F4Bits(dead) & alive;
+            if (pipeInReach) {
+                // 管道碰撞与游戏、离线求解共用 SweptBirdHits：整个子步的扫掠轨迹对所有够得着的管道
+                float fromY[4], toY[4];
+                F4Store(fromY, y0);
+                F4Store(toY, y);
+                for (int lane = 0; lane < 4; lane++) {
+                    if ((alive & ~died & (1 << lane)) && SweptBirdHits(c, fromY[lane], toY[lane], PHYSICS_DT)) died |= 1 << lane;
+                }
+            }
+            for (int lane = 0; lane < 4; lane++) {
+                if (!(alive & (1 << lane))) continue;
+                steps++;
+                if (died & (1 << lane)) {
+                    // 同一步死亡时，离缺口中心越近越好
+                    float yl = pop.y[b + lane];
+                    pop.fitness[b + lane] = step + 1.0f - fabsf(yl - gapCenter) / SCREEN_HEIGHT;
+                    pop.score[b + lane] = c.passed;
+                } else {
+                    float tmpY[4], tmpV[4];
+                    F4Store(tmpY, y);
+                    F4Store(tmpV, vel);
+                    pop.y[b + lane] = tmpY[lane];
+                    pop.vel[b + lane] = tmpV[lane];
+                }
+            }
+            aliveBits[g] = (uint8_t)(alive & ~died);
+            if (!aliveBits[g]) aliveGroups--;
+        }
+    }
+
+    for (int g = 0; g < groups; g++) {
+        for (int lane = 0; lane < 4; lane++) {
+            if (!(aliveBits[g] & (1 << lane))) continue;
+            pop.fitness[begin + g * 4 + lane] = (float)TRAIN_MAX_STEPS + 1.0f;
+            pop.score[begin + g * 4 + lane] = c.passed;
+        }
+    }
+    return steps;
+}
+
+// 精英保留 + 三选一锦标赛 + 高斯扰动；每个子代的随机数只取决于 (代数, 编号)，与线程数无关
+void Evolve(Population& pop, const std::vector<int>& order, uint32_t seed, int generation, int threads) {
+    const int elite = std::max(1, pop.size / 50);
+    const size_t stride = pop.size;
+    ParallelFor(pop.size, threads, [&](int begin, int end) {
+        for (int b = begin; b < end; b++) {
+            uint32_t rng = HashSeed(seed + generation, b);
+            int parent = order[b < elite ? b : 0];
+            if (b >= elite) {
+                parent = (int)(RandomUnit(rng) * pop.size);
+                for (int t = 0; t < 2; t++) {
+                    int rival = (int)(RandomUnit(rng) * pop.size);
+                    if (pop.fitness[rival] > pop.fitness[parent]) parent = rival;
+                }
+            }
+            for (int k = 0; k < GENOME_SIZE; k++) {
+                float v = pop.weights[k * stride + parent];
+                if (b >= elite && RandomUnit(rng) < 0.15f) {
+                    // 三个均匀数之和近似正态
+                    v += (RandomUnit(rng) + RandomUnit(rng) + RandomUnit(rng) - 1.5f) * 0.5f;
+                }
+                pop.next[k * stride + b] = v;
+            }
+        }
+    });
+    pop.weights.swap(pop.next);
+}
+
+// 用法：bird_game --train [代数] [种群数] [线程数] [种子]，最优基因组写入 bird_genome.txt
+void RunTraining(int generations, int size, int threads, uint32_t seed) {
+    if (threads < 1) threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    Population pop;
+    InitPopulation(pop, size, seed);
+    std::vector<int> order(pop.size);
+
+    printf("population %d, threads %d\n", pop.size, threads);
+    printf("%5s %10s %8s %10s %14s %16s\n", "gen", "best", "score", "mean", "steps/s", "steps/s/core");
+    for (int gen = 0; gen < generations; gen++) {
+        uint32_t courseSeed = HashSeed(seed, 0x10000u + gen);
+        std::atomic<long long> steps{ 0 };
+        auto start = std::chrono::steady_clock::now();
+        ParallelFor(pop.size, threads, [&](int begin, int end) { steps += SimulateRange(pop, begin, end, courseSeed); });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (int i = 0; i < pop.size; i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&pop](int a, int b) { return pop.fitness[a] > pop.fitness[b]; });
+        double mean = 0;
+        for (float f : pop.fitness) mean += f;
+        mean /= pop.size;
+        printf("%5d %10.1f %8d %10.1f %14.0f %16.0f\n", gen, pop.fitness[order[0]], pop.score[order[0]], mean,
+               steps.load() / seconds, steps.load() / seconds / threads);
+
+        if (gen == generations - 1) {
+            FILE* f = fopen("bird_genome.txt", "w");
+            if (f) {
+                for (int k = 0; k < GENOME_SIZE; k++) fprintf(f, "%.9g\n", pop.weights[(size_t)k * pop.size + order[0]]);
+                fclose(f);
+                printf("best genome written to bird_genome.txt\n");
+            }
+        } else {
+            Evolve(pop, order, seed, gen, threads);
+        }
+    }
+}
+
+// --- 碰撞基准与穿透回归：bird_game --collision-bench，回归失败时返回非零 ---
+int RunCollisionBenchmark() {
+    // 旧版 0.1s 步长下的掠角穿透：步首、步末两处离散判定都不碰，轨迹却擦过上管口的角
+    const float oldDt = 0.1f;
+    Pipe lip = { BIRD_X + 12.0f, 200.0f, false };
+    float y0 = lip.topHeight - 120.0f, y1 = lip.topHeight + 8.0f;
+    Pipe lipAtStart = { lip.x + PIPE_SPEED * oldDt, lip.topHeight, false };
+    bool discreteMiss = !BirdHitsPipe(y0, lipAtStart) && !BirdHitsPipe(y1, lip);
+    bool sweptHit = SweptBirdHitsPipe(y0, y1, oldDt, lip);
+    // 整条轨迹都在缺口里时不应误报
+    bool cleanPass = !SweptBirdHitsPipe(lip.topHeight + 60.0f, lip.topHeight + 90.0f, oldDt, { BIRD_X - 20.0f, lip.topHeight, false });
+    bool regressionOk = discreteMiss && sweptHit && cleanPass;
+    printf("tunneling regression: %s\n", regressionOk ? "PASS" : "FAIL");
+
+    // 微基准：N 根管道时，旧做法逐根两次离散判定 vs 扫掠判定 + 早退
+    const int CASES = 1 << 16;
+    const int ROUNDS = 64;
+    uint32_t rng = 12345;
+    auto rnd = [&rng](float lo, float hi) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return lo + (hi - lo) * ((rng >> 8) * (1.0f / 16777216.0f));
+    };
+    std::vector<float> ys(CASES + 1);
+    for (float& y : ys) y = rnd(0.0f, (float)SCREEN_HEIGHT);
+
+    const int pipeCounts[] = { 4, 8 };
+    printf("%8s %14s %10s %14s %10s\n", "pipes", "discrete ns", "hits", "swept ns", "hits");
+    for (int pipeCount : pipeCounts) {
+        Course c;
+        ResetCourse(c, 99);
+        float spacing = (SCREEN_WIDTH + 100.0f) / pipeCount;
+        // 第一根固定压在小鸟身上，其余均匀铺满屏幕
+        c.pipes.Push({ BIRD_X - PIPE_WIDTH / 2, rnd(100, 350), false });
+        for (int i = 1; i < pipeCount; i++) c.pipes.Push({ BIRD_X - PIPE_WIDTH / 2 + spacing * i, rnd(100, 350), false });
+
+        int discreteHits = 0, sweptHits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < ROUNDS; r++) {
+            for (int i = 0; i < CASES; i++) {
+                for (int k = 0; k < c.pipes.count; k++) {
+                    const Pipe& p = c.pipes[k];
+                    if (CheckCollisionCircleRec({ BIRD_X, ys[i + 1] }, BIRD_RADIUS, { p.x, 0, PIPE_WIDTH, p.topHeight }) ||
+                        CheckCollisionCircleRec({ BIRD_X, ys[i + 1] }, BIRD_RADIUS, { p.x, p.topHeight + PIPE_GAP, PIPE_WIDTH, (float)SCREEN_HEIGHT })) {
+                        discreteHits++;
+                        break;
+                    }
+                }
+            }
+        }
+        double discreteNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)CASES * ROUNDS);
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < ROUNDS; r++) {
+            for (int i = 0; i < CASES; i++) {
+                // 相邻样本只差几个像素，近似一个物理子步的位移
+                float ya = ys[i], yb = ya + (ys[i + 1] - ya) * 0.02f;
+                if (SweptBirdHits(c, ya, yb, PHYSICS_DT)) sweptHits++;
+            }
+        }
+        double sweptNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)CASES * ROUNDS);
+        printf("%8d %14.2f %10d %14.2f %10d\n", pipeCount, discreteNs, discreteHits, sweptNs, sweptHits);
+    }
+    return regressionOk ? 0 : 1;
+}
+
+// --- 种子可解性预言机：bird_game --oracle <种子> [管道数] [种子个数] [线程数] ---
+// 拍翅只在 60Hz 帧边界发生（与玩家输入一致），物理仍按 240Hz 子步推进。
+// 状态按"上次拍翅后经过的帧数 k"归类：同一类速度完全相同、相对拍翅点的位移也相同，
+// 所以每类只需一个按拍翅高度 (0.5px 精度) 索引的位集，这就是对 (y, 速度, 时间) 的离散化与记忆化：
+//   不拍翅：整类原样进入 k+1；拍翅：各类按各自位移平移后合并进 k=0。
+//   同一类在同一子步的扫掠线段形状相同，安全的拍翅高度是一个区间，二分求出后按位与。
+// 安全区间相对管口高度只取决于 (管道年龄, 拍翅后子步数)，与种子无关，开跑前一次算好供所有线程共享。
+const float ORACLE_Q = 0.5f;
+const int ORACLE_BITS = (int)(SCREEN_HEIGHT / ORACLE_Q) + 1;
+const int SUBSTEPS_PER_FRAME = 4;
+typedef std::bitset<ORACLE_BITS> YSet;
+
+struct OracleResult {
+    bool cleared = false;
+    int maxScore = 0;
+    size_t peakStates = 0;
+    double ms = 0;
+};
+
+YSet RangeMask(int lo, int hi) {
+    YSet m;
+    if (lo < 0) lo = 0;
+    if (hi > ORACLE_BITS - 1) hi = ORACLE_BITS - 1;
+    if (lo > hi) return m;
+    m.set();
+    m >>= ORACLE_BITS - (hi - lo + 1);
+    m <<= lo;
+    return m;
+}
+
+// 形状固定、整体上下平移的线段：起点 y0 越大越不会碰上管，越小越不会碰下管。
+// 返回不碰上管的最小 y0 与不碰下管的最大 y0，二分精度远小于 ORACLE_Q
+void SafeStartRange(const Pipe& p, float dy, float dt, float& minY0, float& maxY0) {
+    Rectangle top, bottom;
+    PipeRects(p, top, bottom);
+    const float x0 = BIRD_X - PIPE_SPEED * dt;
+    const float reach = fabsf(dy) + 2 * BIRD_RADIUS + 1;
+    auto hitsTop = [&](float y) { return SegmentHitsRect(x0, y, BIRD_X, y + dy, top, BIRD_RADIUS); };
+    auto hitsBottom = [&](float y) { return SegmentHitsRect(x0, y, BIRD_X, y + dy, bottom, BIRD_RADIUS); };
+
+    minY0 = -1e9f;
+    float lo = p.topHeight - reach, hi = p.topHeight + reach;
+    if (hitsTop(lo)) {
+        for (int i = 0; i < 12; i++) {
+            float mid = (lo + hi) * 0.5f;
+            if (hitsTop(mid)) lo = mid; else hi = mid;
+        }
+        minY0 = hi;
+    }
+
+    maxY0 = 1e9f;
+    float bottomTop = p.topHeight + PIPE_GAP;
+    lo = bottomTop - reach;
+    hi = bottomTop + reach;
+    if (hitsBottom(hi)) {
+        for (int i = 0; i < 12; i++) {
+            float mid = (lo + hi) * 0.5f;
+            if (hitsBottom(mid)) hi = mid; else lo = mid;
+        }
+        maxY0 = lo;
+    }
+}
+
+struct OracleTables {
+    std::vector<float> disp;        // 拍翅后第 n 个子步的累计位移
+    int firstAge = 0, ages = 0;     // 管道能碰到小鸟的年龄（生成后经过的子步数）范围
+    std::vector<float> topOffset;   // [年龄 * disp.size() + n]：起点 y0 减管口高度的下限
+    std::vector<float> bottomOffset;
+};
+
+int PipeAge(const Pipe& p) {
+    return (int)lroundf((SCREEN_WIDTH - p.x) / (PIPE_SPEED * PHYSICS_DT));
+}
+
+void BuildOracleTables(OracleTables& t) {
+    // 位移表一直延伸到从屏幕顶端出发也必然落出屏幕
+    t.disp.assign(1, 0.0f);
+    for (float y = 0, v = JUMP_FORCE; t.disp.back() <= SCREEN_HEIGHT; ) {
+        v += GRAVITY * PHYSICS_DT;
+        y += v * PHYSICS_DT;
+        t.disp.push_back(y);
+    }
+
+    // 与 StepCourse 相同的浮点递推得到每个年龄的 x
+    std::vector<float> xs;
+    const float minX = BIRD_X - PIPE_SPEED * PHYSICS_DT - BIRD_RADIUS;
+    t.firstAge = -1;
+    float x = (float)SCREEN_WIDTH;
+    for (int age = 1; x + PIPE_WIDTH >= minX; age++) {
+        x -= PIPE_SPEED * PHYSICS_DT;
+        if (x > BIRD_X + BIRD_RADIUS || x + PIPE_WIDTH < minX) continue;
+        if (t.firstAge < 0) t.firstAge = age;
+        xs.push_back(x);
+    }
+    t.ages = (int)xs.size();
+
+    const size_t steps = t.disp.size();
+    t.topOffset.assign((size_t)t.ages * steps, -1e9f);
+    t.bottomOffset.assign((size_t)t.ages * steps, 1e9f);
+    const float refTop = 200.0f;
+    for (int a = 0; a < t.ages; a++) {
+        Pipe p = { xs[a], refTop, false };
+        for (size_t n = 1; n < steps; n++) {
+            float minY0, maxY0;
+            SafeStartRange(p, t.disp[n] - t.disp[n - 1], PHYSICS_DT, minY0, maxY0);
+            t.topOffset[a * steps + n] = minY0 - refTop;
+            t.bottomOffset[a * steps + n] = maxY0 - refTop;
+        }
+    }
+}
+
+OracleResult SolveSeed(const OracleTables& t, uint32_t seed, int targetPipes) {
+    auto start = std::chrono::steady_clock::now();
+    OracleResult result;
+
+    const std::vector<float>& disp = t.disp;
+    const size_t steps = disp.size();
+    const int classes = (int)(disp.size() - 1) / SUBSTEPS_PER_FRAME;
+    std::vector<YSet> cls(classes);
+    std::vector<float> lo(classes), hi(classes);
+
+    // 开局还没拍过翅的那一个状态单独精确模拟
+    bool initAlive = true;
+    float initY = 300.0f, initVel = 0.0f;
+
+    Course c;
+    ResetCourse(c, seed);
+    for (;;) {
+        // 1. 决策：最老的一类直接丢弃（必然已落出屏幕），其余整体后移一类，拍翅的合并进第 0 类
+        YSet flapped;
+        for (int k = 0; k < classes; k++) {
+            if (cls[k].none()) continue;
+            int shift = (int)lroundf(disp[k * SUBSTEPS_PER_FRAME] / ORACLE_Q);
+            flapped |= (shift >= 0) ? (cls[k] << shift) : (cls[k] >> -shift);
+        }
+        if (initAlive) {
+            int i = (int)lroundf(initY / ORACLE_Q);
+            if (i >= 0 && i < ORACLE_BITS) flapped.set(i);
+        }
+        for (int k = classes - 1; k > 0; k--) cls[k] = cls[k - 1];
+        cls[0] = flapped;
+
+        // 2. 推进一帧的 4 个子步，逐类收紧允许的拍翅高度区间
+        for (int k = 0; k < classes; k++) {
+            lo[k] = 0.0f;
+            hi[k] = (float)SCREEN_HEIGHT;
+        }
+        for (int sub = 1; sub <= SUBSTEPS_PER_FRAME; sub++) {
+            if (initAlive) {
+                initVel += GRAVITY * PHYSICS_DT;
+                initY += initVel * PHYSICS_DT;
+                if (initY > SCREEN_HEIGHT || initY < 0) initAlive = false;
+            }
+            StepCourse(c, PHYSICS_DT);
+            if (initAlive && SweptBirdHits(c, initY - initVel * PHYSICS_DT, initY, PHYSICS_DT)) initAlive = false;
+
+            // 本子步可能碰到的管道（正常间距下至多一根）
+            int reachAge[2], reachCount = 0;
+            float reachTop[2];
+            for (int i = 0; i < c.pipes.count && reachCount < 2; i++) {
+                int a = PipeAge(c.pipes[i]) - t.firstAge;
+                if (a >= 0 && a < t.ages) {
+                    reachAge[reachCount] = a;
+                    reachTop[reachCount++] = c.pipes[i].topHeight;
+                }
+            }
+
+            for (int k = 0; k < classes; k++) {
+                if (lo[k] > hi[k] || cls[k].none()) continue;
+                int n = k * SUBSTEPS_PER_FRAME + sub;
+                float d0 = disp[n - 1], d1 = disp[n];
+                lo[k] = fmaxf(lo[k], -d1);
+                hi[k] = fminf(hi[k], SCREEN_HEIGHT - d1);
+                for (int r = 0; r < reachCount; r++) {
+                    size_t idx = reachAge[r] * steps + n;
+                    lo[k] = fmaxf(lo[k], reachTop[r] + t.topOffset[idx] - d0);
+                    hi[k] = fminf(hi[k], reachTop[r] + t.bottomOffset[idx] - d0);
+                }
+            }
+        }
+
+        size_t states = initAlive ? 1 : 0;
+        for (int k = 0; k < classes; k++) {
+            if (cls[k].none()) continue;
+            cls[k] &= RangeMask((int)ceilf(lo[k] / ORACLE_Q), (int)floorf(hi[k] / ORACLE_Q));
+            states += cls[k].count();
+        }
+        if (states == 0) break;
+        result.peakStates = std::max(result.peakStates, states);
+        result.maxScore = c.passed;
+        if (c.passed >= targetPipes) {
+            result.cleared = true;
+            break;
+        }
+    }
+
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void RunOracle(uint32_t firstSeed, int targetPipes, int seedCount, int threads) {
+    if (threads < 1) threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    if (seedCount < 1) seedCount = 1;
+    printf("PIPE_GAP %d, PIPE_SPEED %.0f, spawn every 2.2s, target %d pipes\n", PIPE_GAP, PIPE_SPEED, targetPipes);
+
+    OracleTables tables;
+    BuildOracleTables(tables);
+
+    // 种子之间互不相关，一个种子一个任务，谁先空下来谁领下一个
+    std::vector<OracleResult> results(seedCount);
+    GetBirdPool(threads).Run(seedCount, [&](int i) { results[i] = SolveSeed(tables, firstSeed + i, targetPipes); });
+
+    printf("%12s %8s %10s %12s %10s\n", "seed", "cleared", "max score", "peak states", "ms");
+    int clearedCount = 0;
+    for (int i = 0; i < seedCount; i++) {
+        const OracleResult& r = results[i];
+        if (r.cleared) clearedCount++;
+        printf("%12u %8s %10d %12zu %10.1f\n", firstSeed + i, r.cleared ? "yes" : "no", r.maxScore, r.peakStates, r.ms);
+    }
+    printf("%d / %d seeds clear %d pipes\n", clearedCount, seedCount, targetPipes);
+}
+
+bool LoadGenome(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    int n = 0;
+    while (n < GENOME_SIZE && fscanf(f, "%f", &aiGenome[n]) == 1) n++;
+    fclose(f);
+    return n == GENOME_SIZE;
+}
+
+// --- 预烘焙的视差背景与管道贴图：启动时在 CPU 上画进 Image，之后每层每帧只画一个 UV 滚动的四边形 ---
+// 纹理边长都取 2 的幂，WebGL1 下才能用 REPEAT 平铺
+const int LAYER_TEX_WIDTH = 1024;
+const int GROUND_HEIGHT = 20;
+const int PIPE_TEX_WIDTH = 128;
+const int PIPE_TEX_HEIGHT = 512;
+const int PIPE_LIP_HEIGHT = 24;
+
+struct ParallaxLayer {
+    Texture2D texture;
+    float y;         // 屏幕上的纵向位置
+    float height;    // 屏幕上显示的高度
+    float factor;    // 相对管道速度的滚动比例
+};
+
+ParallaxLayer cloudLayer, skylineLayer, groundLayer;
+Texture2D pipeTexture = { 0 };
+float scrollDistance = 0;   // 管道累计走过的距离，随物理子步推进
+
+Texture2D BakeTexture(Image& img, int wrap) {
+    Texture2D tex = LoadTextureFromImage(img);
+    UnloadImage(img);
+    SetTextureWrap(tex, wrap);
+    return tex;
+}
+
+void LoadBakedGraphics() {
+    uint32_t rng = 4242;
+
+    // 云：几簇半透明圆，左右各补画一份，平铺时首尾相接
+    Image clouds = GenImageColor(LAYER_TEX_WIDTH, 256, BLANK);
+    for (int i = 0; i < 7; i++) {
+        int cx = (int)(RandomUnit(rng) * LAYER_TEX_WIDTH), cy = 50 + (int)(RandomUnit(rng) * 150);
+        for (int k = 0; k < 4; k++) {
+            int ox = (int)(RandomUnit(rng) * 70) - 35, oy = (int)(RandomUnit(rng) * 24) - 12, r = 22 + (int)(RandomUnit(rng) * 22);
+            for (int wrap = -1; wrap <= 1; wrap++) ImageDrawCircle(&clouds, cx + ox + wrap * LAYER_TEX_WIDTH, cy + oy, r, { 255, 255, 255, 100 });
+        }
+    }
+    cloudLayer = { BakeTexture(clouds, TEXTURE_WRAP_REPEAT), 20.0f, 256.0f, 0.1f };
+
+    // 远景楼群：高低不一的剪影和几排窗户，最后一栋正好补满纹理宽度
+    Image skyline = GenImageColor(LAYER_TEX_WIDTH, 128, BLANK);
+    for (int x = 0; x < LAYER_TEX_WIDTH; ) {
+        int w = 30 + (int)(RandomUnit(rng) * 50), h = 40 + (int)(RandomUnit(rng) * 80);
+        if (x + w + 2 + 30 > LAYER_TEX_WIDTH) w = LAYER_TEX_WIDTH - x - 2;
+        ImageDrawRectangle(&skyline, x, 128 - h, w, h, { 90, 150, 185, 255 });
+        for (int wy = 128 - h + 8; wy < 120; wy += 14) {
+            for (int wx = x + 6; wx < x + w - 8; wx += 12) ImageDrawRectangle(&skyline, wx, wy, 4, 6, { 140, 195, 225, 255 });
+        }
+        x += w + 2;
+    }
+    skylineLayer = { BakeTexture(skyline, TEXTURE_WRAP_REPEAT), (float)(SCREEN_HEIGHT - GROUND_HEIGHT - 128), 128.0f, 0.35f };
+
+    // 地面：草皮加深浅相间的土块，与管道同速
+    Image ground = GenImageColor(LAYER_TEX_WIDTH, 32, { 200, 170, 100, 255 });
+    for (int x = 0; x < LAYER_TEX_WIDTH; x += 32) ImageDrawRectangle(&ground, x, 6, 16, 26, { 185, 150, 85, 255 });
+    ImageDrawRectangle(&ground, 0, 0, LAYER_TEX_WIDTH, 6, { 90, 180, 60, 255 });
+    groundLayer = { BakeTexture(ground, TEXTURE_WRAP_REPEAT), (float)(SCREEN_HEIGHT - GROUND_HEIGHT), (float)GROUND_HEIGHT, 1.0f };
+
+    // 管道：第 0 行起是管口，下面是带高光的管身；上管绘制时纵向翻转
+    Image pipe = GenImageColor(PIPE_TEX_WIDTH, PIPE_TEX_HEIGHT, BLANK);
+    ImageDrawRectangle(&pipe, 4, 0, (int)PIPE_WIDTH, PIPE_TEX_HEIGHT, DARKGREEN);
+    ImageDrawRectangle(&pipe, 12, 0, 8, PIPE_TEX_HEIGHT, { 60, 170, 60, 255 });
+    ImageDrawRectangle(&pipe, 52, 0, 8, PIPE_TEX_HEIGHT, { 0, 90, 30, 255 });
+    ImageDrawRectangle(&pipe, 0, 0, (int)PIPE_WIDTH + 8, PIPE_LIP_HEIGHT, { 0, 80, 0, 255 });
+    ImageDrawRectangle(&pipe, 6, 4, 8, PIPE_LIP_HEIGHT - 8, { 40, 140, 40, 255 });
+    pipeTexture = BakeTexture(pipe, TEXTURE_WRAP_CLAMP);
+}
+
+void UnloadBakedGraphics() {
+    UnloadTexture(cloudLayer.texture);
+    UnloadTexture(skylineLayer.texture);
+    UnloadTexture(groundLayer.texture);
+    UnloadTexture(pipeTexture);
+}
+
+void DrawLayer(const ParallaxLayer& layer, float distance) {
+    float offset = fmodf(distance * layer.factor, (float)LAYER_TEX_WIDTH);
+    DrawTextureRec(layer.texture, { offset, 0, (float)SCREEN_WIDTH, layer.height }, { 0, layer.y }, WHITE);
+}
+
+void DrawPipe(float px, float topHeight) {
+    float bottomTop = topHeight + PIPE_GAP;
+    float bottomLen = SCREEN_HEIGHT - bottomTop;
+    // 负的源高度让上管纵向翻转，管口落在缺口一侧
+    DrawTexturePro(pipeTexture, { 0, 0, PIPE_WIDTH + 8, -topHeight }, { px - 4, 0, PIPE_WIDTH + 8, topHeight }, { 0, 0 }, 0, WHITE);
+    DrawTexturePro(pipeTexture, { 0, 0, PIPE_WIDTH + 8, bottomLen }, { px - 4, bottomTop, PIPE_WIDTH + 8, bottomLen }, { 0, 0 }, 0, WHITE);
 }
 
 // --- 自定义几何小鸟绘制函数 ---
@@ -71,71 +960,72 @@ void DrawBird(float x, float y, float velocity) {
     DrawTriangle({x + 10, y}, {x + 10, y + 8}, {x + 20, y + 4}, ORANGE);
 }
 
-void UpdateDrawFrame() {
-    float dt = GetFrameTime();
-    if (dt > 0.1f) dt = 0.1f;
+// 一个物理子步：只依赖当前状态和本步是否拍翅
+void StepGame(bool flap) {
+    prevBirdY = birdY;
+    if (aiPlaying) flap = GenomeWantsFlap(aiGenome, birdY, birdVelocity, NearestPipe(course));
+    if (flap) {
+        birdVelocity = JUMP_FORCE;
+    }
 
-    if (!isGameOver) {
-        if (IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            birdVelocity = JUMP_FORCE;
-        }
-        
-        birdVelocity += GRAVITY * dt;
-        birdY += birdVelocity * dt;
+    birdVelocity += GRAVITY * PHYSICS_DT;
+    birdY += birdVelocity * PHYSICS_DT;
 
-        if (birdY > SCREEN_HEIGHT || birdY < 0) isGameOver = true;
+    if (birdY > SCREEN_HEIGHT || birdY < 0) isGameOver = true;
 
-        pipeTimer += dt;
-        if (pipeTimer > 2.2f) {
-            pipes.push_back({ (float)SCREEN_WIDTH, (float)GetRandomValue(100, 350), false });
-            pipeTimer = 0;
-        }
+    scrollDistance += PIPE_SPEED * PHYSICS_DT;
+    if (StepCourse(course, PHYSICS_DT) > 0) {
+        score = course.passed;
+        #if defined(PLATFORM_WEB)
+        EM_ASM({ if (window.parent && window.parent.UpdateWebScore) window.parent.UpdateWebScore($0); }, score);
+        #endif
+    }
 
-        for (size_t i = 0; i < pipes.size(); i++) {
-            pipes[i].x -= PIPE_SPEED * dt;
+    // 碰撞判定：整个子步的扫掠轨迹，而不只是步末位置
+    if (SweptBirdHits(course, prevBirdY, birdY, PHYSICS_DT)) isGameOver = true;
+}
 
-            // 碰撞判定
-            if (CheckCollisionCircleRec({100, birdY}, 14, { pipes[i].x, 0, 60, pipes[i].topHeight }) || 
-                CheckCollisionCircleRec({100, birdY}, 14, { pipes[i].x, pipes[i].topHeight + PIPE_GAP, 60, (float)SCREEN_HEIGHT })) {
-                isGameOver = true;
-            }
+void UpdateDrawFrame() {
+    if (!isGameOver) {
+        if (IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) pendingFlap = true;
 
-            if (!pipes[i].passed && pipes[i].x < 100) {
-                pipes[i].passed = true;
-                score++;
-                #if defined(PLATFORM_WEB)
-                EM_ASM({ if (window.parent && window.parent.UpdateWebScore) window.parent.UpdateWebScore($0); }, score);
-                #endif
-            }
+        float frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+        physicsAccumulator += frameTime;
+        while (physicsAccumulator >= PHYSICS_DT && !isGameOver) {
+            physicsAccumulator -= PHYSICS_DT;
+            StepGame(pendingFlap);
+            pendingFlap = false;
         }
-        if (!pipes.empty() && pipes[0].x < -100) pipes.erase(pipes.begin());
-
     } else {
         if (IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) ResetGame();
     }
 
+    // 渲染插值：画在上一子步与当前子步之间
+    float alpha = isGameOver ? 1.0f : physicsAccumulator / PHYSICS_DT;
+    float drawBirdY = prevBirdY + (birdY - prevBirdY) * alpha;
+    float pipeLag = PIPE_SPEED * PHYSICS_DT * (1.0f - alpha);
+
     BeginDrawing();
         ClearBackground({ 110, 190, 230, 255 });
 
-        // 绘制背景装饰 (云朵)
-        DrawCircle(150, 100, 30, {255, 255, 255, 100});
-        DrawCircle(180, 110, 40, {255, 255, 255, 100});
-        DrawCircle(500, 150, 35, {255, 255, 255, 100});
+        // 绘制视差背景 (云朵、楼群)
+        float drawDistance = scrollDistance - pipeLag;
+        DrawLayer(cloudLayer, drawDistance);
+        DrawLayer(skylineLayer, drawDistance);
 
         // 绘制小鸟
-        DrawBird(100, birdY, birdVelocity);
+        DrawBird(BIRD_X, drawBirdY, birdVelocity);
         
         // 绘制管道
-        for (const auto& p : pipes) {
-            // 主管子
-            DrawRectangle((int)p.x, 0, 60, (int)p.topHeight, DARKGREEN);
-            DrawRectangle((int)p.x, (int)p.topHeight + PIPE_GAP, 60, SCREEN_HEIGHT, DARKGREEN);
-            // 管道口凸起部分
-            DrawRectangle((int)p.x - 4, (int)p.topHeight - 24, 68, 24, { 0, 80, 0, 255 });
-            DrawRectangle((int)p.x - 4, (int)p.topHeight + PIPE_GAP, 68, 24, { 0, 80, 0, 255 });
+        for (int i = 0; i < course.pipes.count; i++) {
+            const Pipe& p = course.pipes[i];
+            DrawPipe(p.x + pipeLag, p.topHeight);
         }
+        DrawLayer(groundLayer, drawDistance);
 
         DrawText(TextFormat("%d", score), SCREEN_WIDTH/2 - 15, 50, 60, WHITE);
+        if (aiPlaying) DrawText("AI", 20, 20, 20, WHITE);
 
         if (isGameOver) {
             DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.6f));
@@ -145,14 +1035,36 @@ void UpdateDrawFrame() {
     EndDrawing();
 }
 
-int main() {
+int main(int argc, char** argv) {
+#if !defined(PLATFORM_WEB)
+    if (argc > 1 && strcmp(argv[1], "--train") == 0) {
+        RunTraining(argc > 2 ? atoi(argv[2]) : 50, argc > 3 ? atoi(argv[3]) : 10000,
+                    argc > 4 ? atoi(argv[4]) : 0, argc > 5 ? (uint32_t)strtoul(argv[5], nullptr, 10) : 2024u);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--oracle") == 0) {
+        RunOracle((uint32_t)strtoul(argv[2], nullptr, 10), argc > 3 ? atoi(argv[3]) : 1000,
+                  argc > 4 ? atoi(argv[4]) : 1, argc > 5 ? atoi(argv[5]) : 0);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--collision-bench") == 0) {
+        return RunCollisionBenchmark();
+    }
+    if (argc > 2 && strcmp(argv[1], "--watch") == 0) {
+        aiPlaying = LoadGenome(argv[2]);
+        if (!aiPlaying) printf("failed to load genome from %s\n", argv[2]);
+    }
+#endif
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "TinyPulse - Bird");
+    LoadBakedGraphics();
+    ResetGame();
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
     SetTargetFPS(60);
     while (!WindowShouldClose()) UpdateDrawFrame();
 #endif
+    UnloadBakedGraphics();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
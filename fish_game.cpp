@@ -1,7 +1,16 @@
 #include "include/raylib.h"
 #include "include/raymath.h"
+#include "include/rlgl.h"
+#include "include/worker_pool.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -18,123 +27,1174 @@ struct Fish {
     Color color;
 };
 
+// --- 4 路浮点 SIMD：原生 SSE，wasm 上用 simd128，都没有时退回标量 ---
+// 只有 4 路：AVX 需要额外编译选项，桌面和网页两端都按 128 位写一份
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+typedef __m128 F4;
+inline F4 F4Set(float v) { return _mm_set1_ps(v); }
+inline F4 F4Load(const float* p) { return _mm_loadu_ps(p); }
+inline void F4Store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 F4Add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 F4Mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+inline F4 F4Less(F4 a, F4 b) { return _mm_cmplt_ps(a, b); }
+inline F4 F4Or(F4 a, F4 b) { return _mm_or_ps(a, b); }
+inline int F4Bits(F4 mask) { return _mm_movemask_ps(mask); }
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+typedef v128_t F4;
+inline F4 F4Set(float v) { return wasm_f32x4_splat(v); }
+inline F4 F4Load(const float* p) { return wasm_v128_load(p); }
+inline void F4Store(float* p, F4 v) { wasm_v128_store(p, v); }
+inline F4 F4Add(F4 a, F4 b) { return wasm_f32x4_add(a, b); }
+inline F4 F4Mul(F4 a, F4 b) { return wasm_f32x4_mul(a, b); }
+inline F4 F4Less(F4 a, F4 b) { return wasm_f32x4_lt(a, b); }
+inline F4 F4Or(F4 a, F4 b) { return wasm_v128_or(a, b); }
+inline int F4Bits(F4 mask) { return (int)wasm_i32x4_bitmask(mask); }
+#else
+struct F4 { float v[4]; };
+#define F4_MAP(expr) F4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+inline F4 F4Set(float v) { F4_MAP(v); }
+inline F4 F4Load(const float* p) { F4_MAP(p[i]); }
+inline void F4Store(float* p, F4 v) { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+inline F4 F4Add(F4 a, F4 b) { F4_MAP(a.v[i] + b.v[i]); }
+inline F4 F4Mul(F4 a, F4 b) { F4_MAP(a.v[i] * b.v[i]); }
+inline F4 F4Less(F4 a, F4 b) { F4_MAP(a.v[i] < b.v[i] ? 1.0f : 0.0f); }
+inline F4 F4Or(F4 a, F4 b) { F4_MAP((a.v[i] != 0 || b.v[i] != 0) ? 1.0f : 0.0f); }
+inline int F4Bits(F4 mask) { int bits = 0; for (int i = 0; i < 4; i++) if (mask.v[i] != 0) bits |= 1 << i; return bits; }
+#undef F4_MAP
+#endif
+
+// --- 固定步长 ---
+// 模拟固定 60Hz 推进，与显示帧率无关；速度单位是像素/秒，绘制时在两步之间插值
+#define SIM_HZ 60
+#define SIM_DT (1.0f / SIM_HZ)
+#define MAX_FRAME_TIME 0.25f        // 卡顿后最多补这么多秒，避免越补越慢
+#define PLAYER_FOLLOW_RATE 6.32f    // 玩家追鼠标的指数平滑速率，60Hz 下每步正好 0.1
+
+// --- 敌鱼（结构数组，固定容量池） ---
+// 位置、半径、速度分开存放，热循环 4 条一组走 SIMD；
+// 容量是 4 的倍数，尾部几条不用单独走标量。池子一次分配好，
+// 游戏中途不再申请内存，删除时把最后一条挪进空位（swap-and-pop）
+#define MAX_ENEMIES 32768
+
+// 行为类型：直线游过屏幕的普通敌鱼，或者成群游动的小鱼
+#define BEHAVIOR_STRAIGHT 0
+#define BEHAVIOR_SCHOOL 1
+
+struct EnemySoA {
+    float x[MAX_ENEMIES], y[MAX_ENEMIES], radius[MAX_ENEMIES];
+    float speed[MAX_ENEMIES], vy[MAX_ENEMIES];  // speed 即水平速度（像素/秒），正负决定朝向
+    float prevX[MAX_ENEMIES], prevY[MAX_ENEMIES];  // 上一步的位置，绘制插值用
+    uint8_t active[MAX_ENEMIES];
+    uint8_t bigger[MAX_ENEMIES];    // 比玩家大，画成红色
+    uint8_t behavior[MAX_ENEMIES];
+    int count = 0;
+};
+
+// --- 粒子池（背景气泡、吃鱼碎屑、尾迹） ---
+// 与敌鱼一样是预分配的结构数组，4 个一组 SIMD 更新，死掉的 swap-and-pop。
+// 每帧新发射的粒子有上限，池满或超预算就丢弃，网页版池子和预算都更小
+#if defined(PLATFORM_WEB)
+    #define PARTICLE_CAPACITY 16384
+    #define PARTICLE_BUDGET 256     // 每帧最多新发射多少粒子
+#else
+    #define PARTICLE_CAPACITY 65536
+    #define PARTICLE_BUDGET 2048
+#endif
+#define BUBBLE_RATE 30.0f           // 背景气泡每秒生成数
+
+struct ParticlePool {
+    float x[PARTICLE_CAPACITY], y[PARTICLE_CAPACITY];
+    float vx[PARTICLE_CAPACITY], vy[PARTICLE_CAPACITY];
+    float ay[PARTICLE_CAPACITY];        // 竖直加速度：气泡上浮为负，碎屑下沉为正
+    float life[PARTICLE_CAPACITY];      // 剩余秒数
+    float invLife[PARTICLE_CAPACITY];   // 1 / 总寿命，淡出用
+    float size[PARTICLE_CAPACITY];
+    Color color[PARTICLE_CAPACITY];
+    int count = 0;
+    int budget = PARTICLE_BUDGET;       // 本帧剩余的发射额度
+    int dropped = 0;                    // 本帧因预算或容量丢掉的粒子数
+    float bubbleTimer = 0;
+    uint32_t rng = 7;
+};
+
+ParticlePool particles;
+
+// 粒子只管好看，用自己的随机数，不影响游戏的种子序列
+float ParticleRandom(ParticlePool& p, float lo, float hi) {
+    p.rng ^= p.rng << 13; p.rng ^= p.rng >> 17; p.rng ^= p.rng << 5;
+    return lo + (hi - lo) * ((p.rng >> 8) * (1.0f / 16777216.0f));
+}
+
+bool EmitParticle(ParticlePool& p, float x, float y, float vx, float vy, float ay, float life, float size, Color color) {
+    if (p.budget <= 0 || p.count >= PARTICLE_CAPACITY) {
+        p.dropped++;
+        return false;
+    }
+    p.budget--;
+    int i = p.count++;
+    p.x[i] = x;
+    p.y[i] = y;
+    p.vx[i] = vx;
+    p.vy[i] = vy;
+    p.ay[i] = ay;
+    p.life[i] = life;
+    p.invLife[i] = 1.0f / life;
+    p.size[i] = size;
+    p.color[i] = color;
+    return true;
+}
+
+// 吃鱼时向四周炸开的碎屑
+void EmitBurst(ParticlePool& p, float x, float y, Color color, int n) {
+    for (int k = 0; k < n; k++) {
+        float angle = ParticleRandom(p, 0.0f, 2.0f * PI), speed = ParticleRandom(p, 40.0f, 160.0f);
+        if (!EmitParticle(p, x, y, cosf(angle) * speed, sinf(angle) * speed, 120.0f,
+                          ParticleRandom(p, 0.3f, 0.7f), ParticleRandom(p, 1.5f, 3.0f), color)) return;
+    }
+}
+
+void RemoveParticle(ParticlePool& p, int i) {
+    int last = --p.count;
+    p.x[i] = p.x[last];
+    p.y[i] = p.y[last];
+    p.vx[i] = p.vx[last];
+    p.vy[i] = p.vy[last];
+    p.ay[i] = p.ay[last];
+    p.life[i] = p.life[last];
+    p.invLife[i] = p.invLife[last];
+    p.size[i] = p.size[last];
+    p.color[i] = p.color[last];
+}
+
+void UpdateParticles(ParticlePool& p, float dt) {
+    const F4 step = F4Set(dt), minusStep = F4Set(-dt), zero = F4Set(0.0f);
+    int dead = 0;
+    for (int i = 0; i < p.count; i += 4) {
+        F4 vy = F4Add(F4Load(&p.vy[i]), F4Mul(F4Load(&p.ay[i]), step));
+        F4Store(&p.vy[i], vy);
+        F4Store(&p.x[i], F4Add(F4Load(&p.x[i]), F4Mul(F4Load(&p.vx[i]), step)));
+        F4Store(&p.y[i], F4Add(F4Load(&p.y[i]), F4Mul(vy, step)));
+        F4 life = F4Add(F4Load(&p.life[i]), minusStep);
+        F4Store(&p.life[i], life);
+        dead |= F4Bits(F4Less(life, zero));
+    }
+    // 整帧都没有粒子死掉时不用再扫一遍（末尾补齐的几个槽位可能误报，只是多扫一次）
+    if (dead == 0) return;
+    for (int i = 0; i < p.count; ) {
+        if (p.life[i] < 0) RemoveParticle(p, i);
+        else i++;
+    }
+}
+
+// 每帧开头、模拟步之前调用：模拟步里的碎屑和尾迹也算进本帧预算，dropped 到画 HUD 时才是整帧的数
+void BeginParticleFrame(ParticlePool& p) {
+    p.budget = PARTICLE_BUDGET;
+    p.dropped = 0;
+}
+
+// 每帧调用：从视野底下冒背景气泡，再推进所有粒子
+void StepParticles(ParticlePool& p, float dt, Rectangle view) {
+    p.bubbleTimer += dt * BUBBLE_RATE;
+    while (p.bubbleTimer >= 1.0f) {
+        p.bubbleTimer -= 1.0f;
+        float rise = ParticleRandom(p, 30.0f, 60.0f);
+        EmitParticle(p, ParticleRandom(p, view.x, view.x + view.width), view.y + view.height + 5.0f, ParticleRandom(p, -8.0f, 8.0f), -rise, -4.0f,
+                     (view.height + 10.0f) / rise, ParticleRandom(p, 1.5f, 4.0f), { 255, 255, 255, 70 });
+    }
+    UpdateParticles(p, dt);
+}
+
 // --- 全局变量 ---
 Fish player = { {(float)SCREEN_WIDTH/2, (float)SCREEN_HEIGHT/2}, 20.0f, 4.0f, true, YELLOW };
-std::vector<Fish> enemies;
+EnemySoA enemies;
 int gameScore = 0;
 bool isGameOver = false;
 
-// --- 【核心优化】：自定义绘鱼函数 ---
-void DrawFish(Vector2 pos, float radius, Color color, float speed) {
-    bool facingRight = (speed >= 0);
-    float direction = facingRight ? 1.0f : -1.0f;
+// --- 空间哈希（均匀网格，每帧重建） ---
+// 格子坐标哈希到固定数量的桶，桶内按计数排序连续存放鱼的下标；
+// 世界多大都只占 HASH_BUCKETS 个桶，查询只看目标周围几个格子。
+#define HASH_CELL_SIZE 64.0f
+#define HASH_BUCKETS 16384
+#define FISH_EAT_RATIO 1.2f   // 敌鱼之间半径至少大这么多倍才吃得下
+
+struct SpatialHash {
+    std::vector<int> bucketStart;   // HASH_BUCKETS + 1 个前缀和
+    std::vector<int> entries;       // 按桶排好的鱼下标
+    std::vector<int64_t> cellKey;   // 每条鱼所在格子，用来滤掉哈希冲突
+    std::vector<int> cursor;        // 回填用的写指针，留着复用避免每帧分配
+    float maxRadius = 0;
+};
+
+// 按最大条数一次预留好，之后每帧重建都不再分配
+void ReserveSpatialHash(SpatialHash& h, int capacity) {
+    h.bucketStart.reserve(HASH_BUCKETS + 1);
+    h.cursor.reserve(HASH_BUCKETS);
+    h.entries.reserve(capacity);
+    h.cellKey.reserve(capacity);
+}
+
+SpatialHash fishHash;
+long long pairsTested = 0;          // 本帧做过的圆-圆检测次数（含玩家）
+
+int64_t CellKey(int cx, int cy) {
+    return (int64_t)((uint64_t)(uint32_t)cx << 32 | (uint32_t)cy);
+}
+
+int CellBucket(int cx, int cy) {
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u;
+    return (int)(h & (HASH_BUCKETS - 1));
+}
+
+int CellCoord(float v) {
+    return (int)floorf(v / HASH_CELL_SIZE);
+}
+
+void BuildSpatialHash(SpatialHash& h, const float* xs, const float* ys, const float* radii, int n) {
+    h.bucketStart.assign(HASH_BUCKETS + 1, 0);
+    h.entries.resize(n);
+    h.cellKey.resize(n);
+    h.maxRadius = 0;
+    for (int i = 0; i < n; i++) {
+        int cx = CellCoord(xs[i]), cy = CellCoord(ys[i]);
+        h.cellKey[i] = CellKey(cx, cy);
+        h.bucketStart[CellBucket(cx, cy) + 1]++;
+        h.maxRadius = fmaxf(h.maxRadius, radii[i]);
+    }
+    for (int b = 0; b < HASH_BUCKETS; b++) h.bucketStart[b + 1] += h.bucketStart[b];
+    // 倒序回填，桶内保持下标升序
+    h.cursor.assign(h.bucketStart.begin() + 1, h.bucketStart.end());
+    for (int i = n - 1; i >= 0; i--) {
+        int cx = CellCoord(xs[i]), cy = CellCoord(ys[i]);
+        h.entries[--h.cursor[CellBucket(cx, cy)]] = i;
+    }
+}
+
+// 对与 (pos, range) 方框相交的格子里的每条鱼调用 fn(下标)
+template <typename Fn>
+void QuerySpatialHash(const SpatialHash& h, Vector2 pos, float range, Fn fn) {
+    int x0 = CellCoord(pos.x - range), x1 = CellCoord(pos.x + range);
+    int y0 = CellCoord(pos.y - range), y1 = CellCoord(pos.y + range);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int b = CellBucket(cx, cy);
+            int64_t key = CellKey(cx, cy);
+            for (int e = h.bucketStart[b]; e < h.bucketStart[b + 1]; e++) {
+                int i = h.entries[e];
+                if (h.cellKey[i] == key) fn(i);
+            }
+        }
+    }
+}
+
+// 吃掉一条鱼长多少：鱼群里的小鱼只算零食
+float EatGrowth(const EnemySoA& e, int prey, float normal) {
+    return e.behavior[prey] == BEHAVIOR_SCHOOL ? normal * 0.0625f : normal;
+}
+
+// 敌鱼互吃：只从普通敌鱼出发查询（鱼群小鱼之间不互吃），每对只测一次
+void ResolveFishEating(EnemySoA& e, const SpatialHash& h) {
+    for (int i = 0; i < e.count; i++) {
+        if (!e.active[i] || e.behavior[i] != BEHAVIOR_STRAIGHT) continue;
+        QuerySpatialHash(h, { e.x[i], e.y[i] }, e.radius[i] + h.maxRadius, [&](int j) {
+            if (j == i || !e.active[i] || !e.active[j]) return;
+            if (e.behavior[j] == BEHAVIOR_STRAIGHT && j < i) return;
+            pairsTested++;
+            if (!CheckCollisionCircles({ e.x[i], e.y[i] }, e.radius[i], { e.x[j], e.y[j] }, e.radius[j])) return;
+            if (e.radius[i] >= e.radius[j] * FISH_EAT_RATIO) {
+                e.active[j] = 0;
+                e.radius[i] += EatGrowth(e, j, 0.4f);
+                EmitBurst(particles, e.x[j], e.y[j], e.bigger[j] ? RED : GREEN, e.behavior[j] == BEHAVIOR_SCHOOL ? 3 : 12);
+            } else if (e.radius[j] >= e.radius[i] * FISH_EAT_RATIO) {
+                e.active[i] = 0;
+                e.radius[j] += 0.4f;
+                EmitBurst(particles, e.x[i], e.y[i], e.bigger[i] ? RED : GREEN, 12);
+            }
+        });
+    }
+}
+
+// 池满时丢弃这次生成
+bool AddEnemy(EnemySoA& e, float x, float y, float radius, float speed, float vy = 0.0f, int behavior = BEHAVIOR_STRAIGHT) {
+    if (e.count >= MAX_ENEMIES) return false;
+    int i = e.count++;
+    e.x[i] = x;
+    e.y[i] = y;
+    e.prevX[i] = x;
+    e.prevY[i] = y;
+    e.radius[i] = radius;
+    e.speed[i] = speed;
+    e.vy[i] = vy;
+    e.active[i] = 1;
+    e.bigger[i] = 0;
+    e.behavior[i] = (uint8_t)behavior;
+    return true;
+}
+
+// 移动 [begin, end) 的鱼 dt 秒（begin 是 4 的倍数）。bounds 是正在模拟的区域，
+// 鱼群在里面环绕，普通敌鱼游出去就标记删除
+void MoveEnemies(EnemySoA& e, int begin, int end, float dt, Rectangle bounds) {
+    const F4 minX = F4Set(bounds.x), maxX = F4Set(bounds.x + bounds.width);
+    const F4 minY = F4Set(bounds.y), maxY = F4Set(bounds.y + bounds.height);
+    const F4 step = F4Set(dt);
+    for (int i = begin; i < end; i += 4) {
+        F4 x0 = F4Load(&e.x[i]), y0 = F4Load(&e.y[i]);
+        F4Store(&e.prevX[i], x0);
+        F4Store(&e.prevY[i], y0);
+        F4 x = F4Add(x0, F4Mul(F4Load(&e.speed[i]), step));
+        F4 y = F4Add(y0, F4Mul(F4Load(&e.vy[i]), step));
+        F4Store(&e.x[i], x);
+        F4Store(&e.y[i], y);
+        int out = F4Bits(F4Or(F4Or(F4Less(x, minX), F4Less(maxX, x)), F4Or(F4Less(y, minY), F4Less(maxY, y))));
+        if (out == 0) continue;
+        for (int k = 0; k < 4; k++) {
+            int j = i + k;
+            if (!(out & (1 << k))) continue;
+            if (e.behavior[j] == BEHAVIOR_SCHOOL) {
+                // 模拟区域整块挪动时一次可能差出一个区域，用取模环绕
+                e.x[j] = bounds.x + fmodf(fmodf(e.x[j] - bounds.x, bounds.width) + bounds.width, bounds.width);
+                e.y[j] = bounds.y + fmodf(fmodf(e.y[j] - bounds.y, bounds.height) + bounds.height, bounds.height);
+            } else {
+                e.active[j] = 0;
+            }
+        }
+    }
+}
+
+// 颜色动态逻辑：比玩家大的鱼变红，小的变绿
+void ClassifyEnemies(EnemySoA& e, float playerRadius) {
+    const F4 pr = F4Set(playerRadius);
+    for (int i = 0; i < e.count; i += 4) {
+        int big = F4Bits(F4Less(pr, F4Load(&e.radius[i])));
+        for (int k = 0; k < 4; k++) e.bigger[i + k] = (uint8_t)((big >> k) & 1);
+    }
+}
+
+// swap-and-pop：每删一条 O(1)，鱼的顺序会变
+void RemoveEnemy(EnemySoA& e, int i) {
+    int last = --e.count;
+    e.x[i] = e.x[last];
+    e.y[i] = e.y[last];
+    e.prevX[i] = e.prevX[last];
+    e.prevY[i] = e.prevY[last];
+    e.radius[i] = e.radius[last];
+    e.speed[i] = e.speed[last];
+    e.vy[i] = e.vy[last];
+    e.active[i] = e.active[last];
+    e.bigger[i] = e.bigger[last];
+    e.behavior[i] = e.behavior[last];
+}
+
+void RemoveInactiveEnemies(EnemySoA& e) {
+    for (int i = 0; i < e.count; ) {
+        if (e.active[i]) i++;
+        else RemoveEnemy(e, i);
+    }
+}
+
+// --- 常驻线程池（include/worker_pool.h）：每帧复用，避免反复创建线程 ---
+WorkerPool& GetFishPool() {
+    static WorkerPool pool((int)std::thread::hardware_concurrency());
+    return pool;
+}
+
+// --- 鱼群模式（boids：分离、对齐、聚拢） ---
+// 三个阶段：单线程计数排序建网格 → 多线程算转向 → 多线程积分。
+// 转向只读上一帧的位置/速度、写到 steerVx/steerVy，积分再统一换上，
+// 每条鱼的结果只取决于上一帧状态和固定的网格顺序，与线程数无关。
+#define SCHOOL_RADIUS 24.0f         // 感知半径，也是网格边长
+#define SCHOOL_SEPARATION 10.0f
+#define SCHOOL_MAX_NEIGHBORS 24
+#define SCHOOL_MIN_SPEED 60.0f     // 像素/秒
+#define SCHOOL_MAX_SPEED 180.0f
+// 每步的转向增益（按 60Hz 调的，单位都折算到像素/秒）
+#define SCHOOL_SEPARATION_GAIN 90.0f
+#define SCHOOL_ALIGN_GAIN 0.05f
+#define SCHOOL_COHESION_GAIN 0.6f
+#define SCHOOL_FLEE_ACCEL 18.0f
+// 网格盖住整个模拟区域（视野外扩一圈区域，最多 4x4 个屏幕）
+#define SCHOOL_GRID_W ((int)(4 * SCREEN_WIDTH / SCHOOL_RADIUS) + 1)
+#define SCHOOL_GRID_H ((int)(4 * SCREEN_HEIGHT / SCHOOL_RADIUS) + 1)
+#define SCHOOL_TASK_SIZE 1024       // 每个线程任务处理的鱼数，4 的倍数
+#if defined(PLATFORM_WEB)
+    #define SCHOOL_COUNT 4000
+#else
+    #define SCHOOL_COUNT 20000
+#endif
+
+// 建网格时把位置和速度按格子顺序拷一份，邻居扫描是连续内存
+struct SchoolGrid {
+    float originX = 0, originY = 0;
+    int cellStart[SCHOOL_GRID_W * SCHOOL_GRID_H + 1];
+    int cursor[SCHOOL_GRID_W * SCHOOL_GRID_H];
+    int entries[MAX_ENEMIES];
+    float x[MAX_ENEMIES], y[MAX_ENEMIES], vx[MAX_ENEMIES], vy[MAX_ENEMIES];
+};
+
+struct SchoolTimings {
+    double gridMs = 0, steerMs = 0, huntMs = 0, integrateMs = 0;
+    int hunters = 0;
+};
+
+SchoolGrid schoolGrid;
+float steerVx[MAX_ENEMIES], steerVy[MAX_ENEMIES];
+bool schoolMode = false;
+int schoolCount = 0;
+SchoolTimings schoolTimings;
+
+int SchoolCell(const SchoolGrid& g, float x, float y) {
+    int cx = std::min(std::max((int)((x - g.originX) / SCHOOL_RADIUS), 0), SCHOOL_GRID_W - 1);
+    int cy = std::min(std::max((int)((y - g.originY) / SCHOOL_RADIUS), 0), SCHOOL_GRID_H - 1);
+    return cy * SCHOOL_GRID_W + cx;
+}
+
+// 只收鱼群里的鱼，格内按下标升序
+int BuildSchoolGrid(SchoolGrid& g, const EnemySoA& e, Rectangle bounds) {
+    const int cells = SCHOOL_GRID_W * SCHOOL_GRID_H;
+    g.originX = bounds.x;
+    g.originY = bounds.y;
+    memset(g.cellStart, 0, sizeof(g.cellStart));
+    int n = 0;
+    for (int i = 0; i < e.count; i++) {
+        if (e.behavior[i] != BEHAVIOR_SCHOOL) continue;
+        g.cellStart[SchoolCell(g, e.x[i], e.y[i]) + 1]++;
+        n++;
+    }
+    for (int c = 0; c < cells; c++) g.cellStart[c + 1] += g.cellStart[c];
+    memcpy(g.cursor, g.cellStart, sizeof(g.cursor));
+    for (int i = 0; i < e.count; i++) {
+        if (e.behavior[i] != BEHAVIOR_SCHOOL) continue;
+        int k = g.cursor[SchoolCell(g, e.x[i], e.y[i])]++;
+        g.entries[k] = i;
+        g.x[k] = e.x[i];
+        g.y[k] = e.y[i];
+        g.vx[k] = e.speed[i];
+        g.vy[k] = e.vy[i];
+    }
+    return n;
+}
+
+// 处理网格顺序下的第 [begin, end) 条鱼，相邻的鱼邻居也相近
+void SteerSchool(const EnemySoA& e, const SchoolGrid& g, int begin, int end, Vector2 playerPos, float playerRadius) {
+    const float r2 = SCHOOL_RADIUS * SCHOOL_RADIUS, sep2 = SCHOOL_SEPARATION * SCHOOL_SEPARATION;
+    for (int self = begin; self < end; self++) {
+        int i = g.entries[self];
+        float px = g.x[self], py = g.y[self], vx = g.vx[self], vy = g.vy[self];
+        float sepX = 0, sepY = 0, alignX = 0, alignY = 0, cohX = 0, cohY = 0;
+        int neighbors = 0;
+        int cell = SchoolCell(g, px, py), cx = cell % SCHOOL_GRID_W, cy = cell / SCHOOL_GRID_W;
+        for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, SCHOOL_GRID_H - 1) && neighbors < SCHOOL_MAX_NEIGHBORS; ny++) {
+            for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, SCHOOL_GRID_W - 1) && neighbors < SCHOOL_MAX_NEIGHBORS; nx++) {
+                int c = ny * SCHOOL_GRID_W + nx;
+                for (int k = g.cellStart[c]; k < g.cellStart[c + 1] && neighbors < SCHOOL_MAX_NEIGHBORS; k++) {
+                    if (k == self) continue;
+                    float dx = g.x[k] - px, dy = g.y[k] - py;
+                    float d2 = dx * dx + dy * dy;
+                    if (d2 > r2) continue;
+                    neighbors++;
+                    alignX += g.vx[k];
+                    alignY += g.vy[k];
+                    cohX += dx;
+                    cohY += dy;
+                    if (d2 < sep2 && d2 > 0.0001f) {
+                        sepX -= dx / d2;
+                        sepY -= dy / d2;
+                    }
+                }
+            }
+        }
+
+        float ax = sepX * SCHOOL_SEPARATION_GAIN, ay = sepY * SCHOOL_SEPARATION_GAIN;
+        if (neighbors > 0) {
+            float inv = 1.0f / neighbors;
+            ax += (alignX * inv - vx) * SCHOOL_ALIGN_GAIN + cohX * inv * SCHOOL_COHESION_GAIN;
+            ay += (alignY * inv - vy) * SCHOOL_ALIGN_GAIN + cohY * inv * SCHOOL_COHESION_GAIN;
+        }
+        // 躲开比自己大的玩家
+        float fx = px - playerPos.x, fy = py - playerPos.y;
+        float flee = playerRadius + 80.0f;
+        float fd2 = fx * fx + fy * fy;
+        if (playerRadius > e.radius[i] && fd2 < flee * flee && fd2 > 0.0001f) {
+            float inv = SCHOOL_FLEE_ACCEL / sqrtf(fd2);
+            ax += fx * inv;
+            ay += fy * inv;
+        }
+
+        vx += ax;
+        vy += ay;
+        float s = sqrtf(vx * vx + vy * vy);
+        if (s > SCHOOL_MAX_SPEED) { vx *= SCHOOL_MAX_SPEED / s; vy *= SCHOOL_MAX_SPEED / s; }
+        else if (s < SCHOOL_MIN_SPEED) {
+            if (s < 0.0001f) { vx = SCHOOL_MIN_SPEED; vy = 0; }
+            else { vx *= SCHOOL_MIN_SPEED / s; vy *= SCHOOL_MIN_SPEED / s; }
+        }
+        steerVx[i] = vx;
+        steerVy[i] = vy;
+    }
+}
+
+// --- 追猎流场 ---
+// 比玩家大的敌鱼会追玩家。模拟范围铺一张粗网格，从玩家所在格做 8 邻接 BFS，
+// 每格存步数和指向下一格的单位方向；所有猎手共用这一张表，每条鱼只查一次格子。
+// 流场每 FLOW_INTERVAL 步才检查一次，玩家格子和模拟范围都没变就不重算
+#define FLOW_CELL 80.0f
+#define FLOW_W ((int)(4 * SCREEN_WIDTH / FLOW_CELL))
+#define FLOW_H ((int)(4 * SCREEN_HEIGHT / FLOW_CELL))
+#define FLOW_INTERVAL 4
+#define HUNT_RANGE 6                // 猎手离玩家不超过这么多格才追
+#define HUNT_TURN_RATE 2.5f         // 猎手转向的最大角速度（弧度/秒），背对玩家也能掉头
+#define FLOW_UNREACHED 0xFFFF
+
+struct FlowField {
+    bool valid = false;
+    float originX = 0, originY = 0;
+    float width = 0, height = 0;    // 建场时模拟范围的尺寸，变了就要重建
+    int w = 0, h = 0;               // 本次用到的格子数（不超过 FLOW_W x FLOW_H）
+    int targetCell = -1;
+    uint16_t dist[FLOW_W * FLOW_H];
+    float dirX[FLOW_W * FLOW_H], dirY[FLOW_W * FLOW_H];
+    int queue[FLOW_W * FLOW_H];
+    long long rebuilds = 0;
+    double lastBuildMs = 0;
+};
+
+FlowField flowField;
+
+int FlowCell(const FlowField& f, float x, float y) {
+    int cx = (int)floorf((x - f.originX) / FLOW_CELL), cy = (int)floorf((y - f.originY) / FLOW_CELL);
+    if (cx < 0 || cy < 0 || cx >= f.w || cy >= f.h) return -1;
+    return cy * f.w + cx;
+}
+
+void BuildFlowField(FlowField& f, Rectangle bounds, Vector2 target) {
+    auto start = std::chrono::steady_clock::now();
+    f.originX = bounds.x;
+    f.originY = bounds.y;
+    f.width = bounds.width;
+    f.height = bounds.height;
+    f.w = std::min((int)ceilf(bounds.width / FLOW_CELL), FLOW_W);
+    f.h = std::min((int)ceilf(bounds.height / FLOW_CELL), FLOW_H);
+    int cells = f.w * f.h;
+    for (int c = 0; c < cells; c++) f.dist[c] = FLOW_UNREACHED;
+    f.targetCell = FlowCell(f, target.x, target.y);
+    f.valid = f.targetCell >= 0;
+    if (!f.valid) return;
+
+    static const int NX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    static const int NY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    int head = 0, tail = 0;
+    f.dist[f.targetCell] = 0;
+    f.queue[tail++] = f.targetCell;
+    while (head < tail) {
+        int c = f.queue[head++], cx = c % f.w, cy = c / f.w;
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + NX[k], ny = cy + NY[k];
+            if (nx < 0 || ny < 0 || nx >= f.w || ny >= f.h) continue;
+            int n = ny * f.w + nx;
+            if (f.dist[n] != FLOW_UNREACHED) continue;
+            f.dist[n] = f.dist[c] + 1;
+            f.queue[tail++] = n;
+        }
+    }
+    // 方向指向步数最小的邻格；直边优先，斜边其次，顺序固定保证确定性
+    const float diag = 0.70710678f;
+    for (int c = 0; c < cells; c++) {
+        int cx = c % f.w, cy = c / f.w, best = -1;
+        uint16_t bestDist = f.dist[c];
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + NX[k], ny = cy + NY[k];
+            if (nx < 0 || ny < 0 || nx >= f.w || ny >= f.h) continue;
+            if (f.dist[ny * f.w + nx] < bestDist) { bestDist = f.dist[ny * f.w + nx]; best = k; }
+        }
+        float scale = (best >= 4) ? diag : 1.0f;
+        f.dirX[c] = best >= 0 ? NX[best] * scale : 0.0f;
+        f.dirY[c] = best >= 0 ? NY[best] * scale : 0.0f;
+    }
+    f.rebuilds++;
+    f.lastBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void UpdateFlowField(FlowField& f, Rectangle bounds, Vector2 target, long long tick) {
+    if (tick % FLOW_INTERVAL != 0 && f.valid) return;
+    if (f.valid && f.originX == bounds.x && f.originY == bounds.y && f.width == bounds.width && f.height == bounds.height &&
+        FlowCell(f, target.x, target.y) == f.targetCell) return;
+    BuildFlowField(f, bounds, target);
+}
+
+// 猎手转向：查自己所在格的方向，速度大小不变，航向按最大角速度转过去；
+// 正背对时也按固定方向掉头。不追的大鱼慢慢回到水平游动。返回这段里有多少条在追
+int SteerHunters(EnemySoA& e, const FlowField& f, int begin, int end, Vector2 playerPos, float dt) {
+    const float maxTurn = HUNT_TURN_RATE * dt;
+    int hunters = 0;
+    for (int i = begin; i < end; i++) {
+        if (e.behavior[i] != BEHAVIOR_STRAIGHT || !e.bigger[i]) continue;
+        int c = FlowCell(f, e.x[i], e.y[i]);
+        float vx = e.speed[i], vy = e.vy[i];
+        float mag = sqrtf(vx * vx + vy * vy);
+        if (c < 0 || f.dist[c] > HUNT_RANGE) {
+            e.vy[i] = vy * 0.98f;
+            continue;
+        }
+        hunters++;
+        float dx = f.dirX[c], dy = f.dirY[c];
+        if (c == f.targetCell) {
+            // 已经和玩家同格，直接对准
+            dx = playerPos.x - e.x[i];
+            dy = playerPos.y - e.y[i];
+            float d = sqrtf(dx * dx + dy * dy);
+            if (d < 0.0001f) continue;
+            dx /= d;
+            dy /= d;
+        }
+        if (mag < 0.0001f) continue;
+        // 当前航向到期望方向的夹角，限幅后旋转速度
+        float angle = atan2f(vx * dy - vy * dx, vx * dx + vy * dy);
+        float turn = Clamp(angle, -maxTurn, maxTurn);
+        float cs = cosf(turn), sn = sinf(turn);
+        e.speed[i] = vx * cs - vy * sn;
+        e.vy[i] = vx * sn + vy * cs;
+    }
+    return hunters;
+}
+
+// 一步的敌鱼运动：有鱼群时先建网格、算转向，再并行让猎手转向、积分；各阶段耗时记到 schoolTimings
+void StepEnemies(EnemySoA& e, WorkerPool& pool, Vector2 playerPos, float playerRadius, float dt, Rectangle bounds) {
+    int tasks = (e.count + SCHOOL_TASK_SIZE - 1) / SCHOOL_TASK_SIZE;
+    auto t0 = std::chrono::steady_clock::now();
+    schoolCount = BuildSchoolGrid(schoolGrid, e, bounds);
+    auto t1 = std::chrono::steady_clock::now();
+    if (schoolCount > 0) {
+        int steerTasks = (schoolCount + SCHOOL_TASK_SIZE - 1) / SCHOOL_TASK_SIZE;
+        // 只按引用捕获一个对象，std::function 放得进内部缓冲，不会每帧分配
+        struct { const EnemySoA* e; Vector2 pos; float radius; } job = { &e, playerPos, playerRadius };
+        pool.Run(steerTasks, [&job](int t) {
+            SteerSchool(*job.e, schoolGrid, t * SCHOOL_TASK_SIZE, std::min((t + 1) * SCHOOL_TASK_SIZE, schoolCount), job.pos, job.radius);
+        });
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    schoolTimings.hunters = 0;
+    if (flowField.valid) {
+        std::atomic<int> hunters{0};
+        struct { EnemySoA* e; Vector2 pos; float dt; std::atomic<int>* hunters; } hunt = { &e, playerPos, dt, &hunters };
+        pool.Run(tasks, [&hunt](int t) {
+            int begin = t * SCHOOL_TASK_SIZE, end = std::min(begin + SCHOOL_TASK_SIZE, hunt.e->count);
+            *hunt.hunters += SteerHunters(*hunt.e, flowField, begin, end, hunt.pos, hunt.dt);
+        });
+        schoolTimings.hunters = hunters;
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    struct { EnemySoA* e; float dt; Rectangle bounds; } move = { &e, dt, bounds };
+    pool.Run(tasks, [&move](int t) {
+        EnemySoA& e = *move.e;
+        int begin = t * SCHOOL_TASK_SIZE, end = std::min(begin + SCHOOL_TASK_SIZE, e.count);
+        if (schoolCount > 0) {
+            for (int i = begin; i < end; i++) {
+                if (e.behavior[i] != BEHAVIOR_SCHOOL) continue;
+                e.speed[i] = steerVx[i];
+                e.vy[i] = steerVy[i];
+            }
+        }
+        MoveEnemies(e, begin, end, move.dt, move.bounds);
+    });
+    auto t4 = std::chrono::steady_clock::now();
+    schoolTimings.gridMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    schoolTimings.steerMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    schoolTimings.huntMs = std::chrono::duration<double, std::milli>(t3 - t2).count();
+    schoolTimings.integrateMs = std::chrono::duration<double, std::milli>(t4 - t3).count();
+}
 
-    // 1. 绘制尾巴 (使用更稳健的坐标计算)
-    // 尾巴尖部连接点
+// 在 area 里随机撒一群小鱼，用自带的随机数保证同一种子同一布局
+void SpawnSchool(EnemySoA& e, int count, uint32_t seed, Rectangle area) {
+    uint32_t rng = seed ? seed : 1;
+    auto rnd = [&rng](float lo, float hi) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return lo + (hi - lo) * ((rng >> 8) * (1.0f / 16777216.0f));
+    };
+    for (int i = 0; i < count; i++) {
+        float angle = rnd(0.0f, 2.0f * PI), s = rnd(SCHOOL_MIN_SPEED, SCHOOL_MAX_SPEED);
+        if (!AddEnemy(e, rnd(area.x, area.x + area.width), rnd(area.y, area.y + area.height), rnd(3.0f, 5.0f), cosf(angle) * s, sinf(angle) * s, BEHAVIOR_SCHOOL)) break;
+    }
+}
+
+void ClearSchool(EnemySoA& e) {
+    for (int i = 0; i < e.count; i++) {
+        if (e.behavior[i] == BEHAVIOR_SCHOOL) e.active[i] = 0;
+    }
+    RemoveInactiveEnemies(e);
+}
+
+// --- 【核心优化】：批量绘鱼 ---
+// 所有鱼的三角形先写进一块预分配的顶点数组，再用 rlgl 一次上传、一次绘制；
+// 缓冲写满才会多画一次，画面里多少条鱼都只有一两次 draw call。
+// 身体椭圆按半径分档细分，小鱼少切几刀，太小的鱼不画眼睛。
+#define FISH_BATCH_VERTICES (1 << 18)
+#define FISH_LOD_LEVELS 3
+
+struct FishBatch {
+    unsigned int vao = 0, vboPosition = 0, vboColor = 0;
+    float positions[FISH_BATCH_VERTICES * 2];
+    unsigned char colors[FISH_BATCH_VERTICES * 4];
+    int vertexCount = 0;
+    int drawCalls = 0;              // 本帧的 draw call 数
+    int frameVertices = 0;          // 本帧提交的顶点数
+};
+
+const int fishLodSegments[FISH_LOD_LEVELS] = { 6, 12, 24 };
+Vector2 fishLodCircle[FISH_LOD_LEVELS][24 + 1];   // 各档的单位圆顶点，首尾相同
+FishBatch fishBatch;
+
+int FishLod(float radius) {
+    return radius < 6.0f ? 0 : (radius < 16.0f ? 1 : 2);
+}
+
+void LoadFishBatch(FishBatch& b) {
+    for (int l = 0; l < FISH_LOD_LEVELS; l++) {
+        for (int k = 0; k <= fishLodSegments[l]; k++) {
+            float a = 2.0f * PI * k / fishLodSegments[l];
+            fishLodCircle[l][k] = { cosf(a), sinf(a) };
+        }
+    }
+    int* locs = rlGetShaderLocsDefault();
+    b.vao = rlLoadVertexArray();
+    rlEnableVertexArray(b.vao);
+    b.vboPosition = rlLoadVertexBuffer(b.positions, sizeof(b.positions), true);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+    b.vboColor = rlLoadVertexBuffer(b.colors, sizeof(b.colors), true);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, 0, 0);
+    rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+    rlDisableVertexArray();
+}
+
+void UnloadFishBatch(FishBatch& b) {
+    rlUnloadVertexArray(b.vao);
+    rlUnloadVertexBuffer(b.vboPosition);
+    rlUnloadVertexBuffer(b.vboColor);
+}
+
+// 把攒下的三角形画出去。先刷掉 raylib 自己的批次，保证与其他图元的先后顺序
+void FlushFishBatch(FishBatch& b) {
+    if (b.vertexCount == 0) return;
+    rlDrawRenderBatchActive();
+    rlUpdateVertexBuffer(b.vboPosition, b.positions, b.vertexCount * 2 * sizeof(float), 0);
+    rlUpdateVertexBuffer(b.vboColor, b.colors, b.vertexCount * 4, 0);
+
+    int* locs = rlGetShaderLocsDefault();
+    rlEnableShader(rlGetShaderIdDefault());
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+    int slot = 0;
+    rlSetUniform(locs[RL_SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(rlGetTextureIdDefault());
+    // 朝左的鱼是镜像出来的，绕序相反，画时关掉背面剔除
+    rlDisableBackfaceCulling();
+    if (!rlEnableVertexArray(b.vao)) {
+        rlEnableVertexBuffer(b.vboPosition);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+        rlEnableVertexBuffer(b.vboColor);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, 0, 0);
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+    }
+    rlDrawVertexArray(0, b.vertexCount);
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlEnableBackfaceCulling();
+    rlDisableTexture();
+    rlDisableShader();
+
+    b.drawCalls++;
+    b.frameVertices += b.vertexCount;
+    b.vertexCount = 0;
+}
+
+inline void PushFishTriangle(FishBatch& b, Vector2 p0, Vector2 p1, Vector2 p2, Color c) {
+    if (b.vertexCount + 3 > FISH_BATCH_VERTICES) FlushFishBatch(b);
+    const Vector2 v[3] = { p0, p1, p2 };
+    for (int k = 0; k < 3; k++) {
+        int i = b.vertexCount++;
+        b.positions[i * 2] = v[k].x;
+        b.positions[i * 2 + 1] = v[k].y;
+        b.colors[i * 4] = c.r;
+        b.colors[i * 4 + 1] = c.g;
+        b.colors[i * 4 + 2] = c.b;
+        b.colors[i * 4 + 3] = c.a;
+    }
+}
+
+void PushEllipse(FishBatch& b, Vector2 center, float rx, float ry, int lod, Color c) {
+    const Vector2* circle = fishLodCircle[lod];
+    for (int k = 0; k < fishLodSegments[lod]; k++) {
+        PushFishTriangle(b, center, { center.x + circle[k].x * rx, center.y + circle[k].y * ry },
+                         { center.x + circle[k + 1].x * rx, center.y + circle[k + 1].y * ry }, c);
+    }
+}
+
+// 一条鱼的实例：位置、大小、朝向（speed 的正负）和颜色
+void BatchFish(FishBatch& b, Vector2 pos, float radius, Color color, float speed) {
+    float direction = (speed >= 0) ? 1.0f : -1.0f;
+    int lod = FishLod(radius);
+
+    // 1. 尾巴：连接点和上下两个张开的尖
     Vector2 joint = { pos.x - (radius * 1.2f * direction), pos.y };
-    // 尾巴上下两个张开的点
     Vector2 tip1 = { pos.x - (radius * 2.2f * direction), pos.y - radius * 0.8f };
     Vector2 tip2 = { pos.x - (radius * 2.2f * direction), pos.y + radius * 0.8f };
+    PushFishTriangle(b, joint, tip1, tip2, color);
 
-    // 关键修复：无论向左向右，确保顶点顺序一致
-    if (facingRight) {
-        DrawTriangle(joint, tip1, tip2, color);
-    } else {
-        // 向左时，交换 tip1 和 tip2 的顺序，确保逆时针排列
-        DrawTriangle(joint, tip2, tip1, color);
+    // 2. 身体 (椭圆)
+    PushEllipse(b, pos, radius * 1.5f, radius, lod, color);
+
+    // 3. 眼睛
+    if (lod == 0) return;
+    Vector2 eye = { pos.x + radius * 0.8f * direction, pos.y - radius * 0.3f };
+    PushEllipse(b, eye, radius * 0.2f, radius * 0.2f, 0, WHITE);
+    PushEllipse(b, eye, radius * 0.1f, radius * 0.1f, 0, BLACK);
+}
+
+// 每个粒子一个方块（两个三角形），越接近寿命尽头越透明
+void BatchParticles(FishBatch& b, const ParticlePool& p) {
+    for (int i = 0; i < p.count; i++) {
+        float s = p.size[i], fade = fminf(p.life[i] * p.invLife[i] * 2.0f, 1.0f);
+        Color c = p.color[i];
+        c.a = (unsigned char)(c.a * fade);
+        Vector2 a = { p.x[i] - s, p.y[i] - s }, d = { p.x[i] + s, p.y[i] + s };
+        PushFishTriangle(b, a, { a.x, d.y }, d, c);
+        PushFishTriangle(b, a, d, { d.x, a.y }, c);
     }
+}
+
+// --- 带种子的生成表 ---
+// 敌鱼按泊松过程生成：间隔取指数分布。
+// 屏上由一张视野生成表按 SPAWN_RATE 从视野左右边外放鱼（原来每帧 3/101 的概率），
+// 与视野横跨几个区域无关；视野外的区域各自按 REGION_SPAWN_RATE 补充背景鱼。
+// 大小、速度、位置、方向都从各自的随机流里取，同一种子同样的操作得到同样的一局
+#define SPAWN_RATE 1.78f
+#define REGION_SPAWN_RATE 0.2f
+
+struct SpawnSchedule {
+    uint64_t rng = 1;
+    double nextSpawn = 0;           // 下一条鱼的生成时刻（模拟秒）
+};
 
-    // 2. 绘制身体 (椭圆)
-    DrawEllipse((int)pos.x, (int)pos.y, radius * 1.5f, radius, color);
+SpawnSchedule spawnSchedule;
+long long simTicks = 0;
+float simAccumulator = 0;
+Vector2 prevPlayerPosition;
 
-    // 3. 绘制眼睛
-    float eyeOffsetX = radius * 0.8f * direction;
-    float eyeOffsetY = -radius * 0.3f;
-    DrawCircleV({pos.x + eyeOffsetX, pos.y + eyeOffsetY}, radius * 0.2f, WHITE);
-    DrawCircleV({pos.x + eyeOffsetX, pos.y + eyeOffsetY}, radius * 0.1f, BLACK);
+uint64_t NextScheduleRandom(SpawnSchedule& s) {
+    uint64_t z = (s.rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
 }
-void SpawnEnemy() {
-    float r = (float)GetRandomValue(8, (int)player.radius + 15);
-    float s = (float)GetRandomValue(2, 5);
-    float y = (float)GetRandomValue(50, SCREEN_HEIGHT - 50);
-    
-    if (GetRandomValue(0, 1) == 0) { // 从左侧出
-        enemies.push_back({ {-100, y}, r, s, true, GREEN });
-    } else { // 从右侧出
-        enemies.push_back({ {(float)SCREEN_WIDTH + 100, y}, r, -s, true, RED });
-    }
+
+// [lo, hi] 上的整数，与 GetRandomValue 同样含两端
+int ScheduleInt(SpawnSchedule& s, int lo, int hi) {
+    return lo + (int)(NextScheduleRandom(s) % (uint64_t)(hi - lo + 1));
 }
 
-void UpdateDrawFrame() {
-    if (!isGameOver) {
-        // 玩家控制：平滑跟随鼠标
-        Vector2 mousePos = GetMousePosition();
-        float moveX = (mousePos.x - player.position.x) * 0.1f;
-        player.position.x += moveX;
-        player.position.y += (mousePos.y - player.position.y) * 0.1f;
-
-        // 根据移动方向确定玩家的伪“速度”，用于绘制朝向
-        float playerDir = (moveX >= 0) ? 1.0f : -1.0f;
-
-        if (GetRandomValue(0, 100) < 3) SpawnEnemy();
-
-        for (size_t i = 0; i < enemies.size(); i++) {
-            enemies[i].position.x += enemies[i].speed;
-            
-            // 颜色动态逻辑：比玩家大的鱼变红，小的变绿
-            enemies[i].color = (enemies[i].radius > player.radius) ? RED : GREEN;
-
-            if (CheckCollisionCircles(player.position, player.radius, enemies[i].position, enemies[i].radius)) {
-                if (player.radius >= enemies[i].radius) {
-                    enemies[i].active = false;
-                    player.radius += 0.8f;
-                    gameScore += 10;
-                } else {
-                    isGameOver = true;
-                    #if defined(PLATFORM_WEB)
-                    EM_ASM({
-                        if (typeof window.parent.UpdateWebScore === 'function') window.parent.UpdateWebScore($0);
-                        else if (typeof UpdateWebScore === 'function') UpdateWebScore($0);
-                    }, gameScore);
-                    #endif
+// (0, 1] 上的浮点数
+double ScheduleUnit(SpawnSchedule& s) {
+    return ((NextScheduleRandom(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+void ScheduleNextSpawn(SpawnSchedule& s, float rate) {
+    s.nextSpawn += -log(ScheduleUnit(s)) / rate;
+}
+
+// --- 分区流式海洋 ---
+// 世界由 WORLD_REGIONS_X x WORLD_REGIONS_Y 个屏幕大小的区域拼成，镜头跟着玩家。
+// 只有视野外扩一圈的区域在模拟（最多 4x4 个），其余区域冻结、不占任何内存：
+// 区域的鱼完全由 (世界种子, 区域坐标) 决定，进入模拟范围时按种子重新生成，
+// 游出模拟范围的鱼直接删掉。CPU 和内存只跟视野周围有关，与世界大小无关
+#define WORLD_REGIONS_X 64
+#define WORLD_REGIONS_Y 8
+#define WORLD_WIDTH ((float)SCREEN_WIDTH * WORLD_REGIONS_X)
+#define WORLD_HEIGHT ((float)SCREEN_HEIGHT * WORLD_REGIONS_Y)
+#define REGION_POPULATION 6         // 区域刚进入模拟范围时的敌鱼数
+#define REGION_FISH_RADIUS 35       // 视野外区域里敌鱼的体型上限（开局玩家体型 + 15）
+#define MAX_ACTIVE_REGIONS 16
+
+struct ActiveRegion {
+    int rx, ry;
+    bool visible;                   // 与视野相交的区域不自己出鱼，屏上的鱼归视野生成表管
+    SpawnSchedule schedule;
+};
+
+struct OceanWorld {
+    uint64_t seed = 1;
+    ActiveRegion regions[MAX_ACTIVE_REGIONS];
+    int count = 0;
+    int rx0 = 0, ry0 = 0, rx1 = -1, ry1 = -1;   // 模拟范围（含两端），rx1 < rx0 表示还没有
+    Rectangle bounds = { 0, 0, 0, 0 };          // 模拟范围的世界坐标
+    Rectangle view = { 0, 0, 0, 0 };
+    SpawnSchedule viewSchedule;                 // 屏上出鱼的生成表，只跟时间有关
+    long long activations = 0;
+};
+
+OceanWorld ocean;
+Camera2D camera = { { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f }, { 0, 0 }, 0.0f, 1.0f };
+
+uint64_t RegionSeed(uint64_t worldSeed, int rx, int ry) {
+    SpawnSchedule s;
+    s.rng = worldSeed ^ ((uint64_t)(uint32_t)rx << 32 | (uint32_t)ry);
+    return NextScheduleRandom(s);
+}
+
+// 镜头对准 center，但不越出世界边界
+Rectangle ViewRect(Vector2 center) {
+    float x = fminf(fmaxf(center.x - SCREEN_WIDTH / 2.0f, 0.0f), WORLD_WIDTH - SCREEN_WIDTH);
+    float y = fminf(fmaxf(center.y - SCREEN_HEIGHT / 2.0f, 0.0f), WORLD_HEIGHT - SCREEN_HEIGHT);
+    return { x, y, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT };
+}
+
+// 在视野外的区域里随机放一条直线游动的敌鱼：只看种子和区域坐标，体型范围固定、不管玩家在哪，
+// 区域回到范围内时重放出同样的鱼
+void SpawnRegionFish(ActiveRegion& r) {
+    SpawnSchedule& s = r.schedule;
+    float radius = (float)ScheduleInt(s, 8, REGION_FISH_RADIUS);
+    float speed = (float)ScheduleInt(s, 2, 5) * SIM_HZ;     // 原来 2~5 像素/帧
+    float x = r.rx * (float)SCREEN_WIDTH + (float)ScheduleInt(s, 0, SCREEN_WIDTH - 1);
+    float y = r.ry * (float)SCREEN_HEIGHT + (float)ScheduleInt(s, 50, SCREEN_HEIGHT - 50);
+    if (ScheduleInt(s, 0, 1) != 0) speed = -speed;
+    AddEnemy(enemies, x, y, radius, speed);
+}
+
+// 屏上出鱼：像原来一样按玩家体型，从视野左右边外 100 像素（不越出模拟范围）游进来，离玩家太近就放弃
+void SpawnViewFish(OceanWorld& w) {
+    SpawnSchedule& s = w.viewSchedule;
+    float radius = (float)ScheduleInt(s, 8, (int)player.radius + 15);
+    float speed = (float)ScheduleInt(s, 2, 5) * SIM_HZ;
+    float y = w.view.y + (float)ScheduleInt(s, 50, SCREEN_HEIGHT - 50);
+    bool fromLeft = ScheduleInt(s, 0, 1) == 0;
+    if (!fromLeft) speed = -speed;
+    float x = fromLeft ? fmaxf(w.view.x - 100.0f, w.bounds.x) : fminf(w.view.x + w.view.width + 100.0f, w.bounds.x + w.bounds.width);
+    if (Vector2Distance({ x, y }, player.position) < 200.0f) return;
+    AddEnemy(enemies, x, y, radius, speed);
+}
+
+// 按视野重新划定模拟范围：新进来的区域按种子生成，留下的区域保持生成时钟
+void UpdateActiveRegions(OceanWorld& w, Rectangle view, double now) {
+    int vx0 = (int)(view.x / SCREEN_WIDTH), vx1 = (int)((view.x + view.width - 1) / SCREEN_WIDTH);
+    int vy0 = (int)(view.y / SCREEN_HEIGHT), vy1 = (int)((view.y + view.height - 1) / SCREEN_HEIGHT);
+    int rx0 = std::max(vx0 - 1, 0), rx1 = std::min(vx1 + 1, WORLD_REGIONS_X - 1);
+    int ry0 = std::max(vy0 - 1, 0), ry1 = std::min(vy1 + 1, WORLD_REGIONS_Y - 1);
+
+    if (rx0 != w.rx0 || rx1 != w.rx1 || ry0 != w.ry0 || ry1 != w.ry1) {
+        ActiveRegion next[MAX_ACTIVE_REGIONS];
+        int n = 0;
+        for (int ry = ry0; ry <= ry1; ry++) {
+            for (int rx = rx0; rx <= rx1; rx++) {
+                ActiveRegion* kept = nullptr;
+                for (int i = 0; i < w.count; i++) {
+                    if (w.regions[i].rx == rx && w.regions[i].ry == ry) kept = &w.regions[i];
                 }
+                ActiveRegion& r = next[n++];
+                if (kept) {
+                    r = *kept;
+                    continue;
+                }
+                r.rx = rx;
+                r.ry = ry;
+                r.schedule.rng = RegionSeed(w.seed, rx, ry);
+                r.schedule.nextSpawn = now;
+                ScheduleNextSpawn(r.schedule, REGION_SPAWN_RATE);
+                for (int k = 0; k < REGION_POPULATION; k++) SpawnRegionFish(r);
+                w.activations++;
             }
         }
+        memcpy(w.regions, next, sizeof(ActiveRegion) * n);
+        w.count = n;
+        w.rx0 = rx0; w.rx1 = rx1; w.ry0 = ry0; w.ry1 = ry1;
+        w.bounds = { rx0 * (float)SCREEN_WIDTH, ry0 * (float)SCREEN_HEIGHT,
+                     (rx1 - rx0 + 1) * (float)SCREEN_WIDTH, (ry1 - ry0 + 1) * (float)SCREEN_HEIGHT };
+    }
+    w.view = view;
+    for (int i = 0; i < w.count; i++) {
+        ActiveRegion& r = w.regions[i];
+        r.visible = r.rx >= vx0 && r.rx <= vx1 && r.ry >= vy0 && r.ry <= vy1;
+    }
+}
 
-        auto it = enemies.begin();
-        while (it != enemies.end()) {
-            if (!it->active || it->position.x < -300 || it->position.x > SCREEN_WIDTH + 300) {
-                it = enemies.erase(it);
+// 屏上的鱼只来自视野生成表；看得见的区域照样走时钟但不出鱼，移出视野后接着按自己的节奏补
+void SpawnFromRegions(OceanWorld& w, double now) {
+    while (w.viewSchedule.nextSpawn <= now) {
+        SpawnViewFish(w);
+        ScheduleNextSpawn(w.viewSchedule, SPAWN_RATE);
+    }
+    for (int i = 0; i < w.count; i++) {
+        ActiveRegion& r = w.regions[i];
+        while (r.schedule.nextSpawn <= now) {
+            if (!r.visible) SpawnRegionFish(r);
+            ScheduleNextSpawn(r.schedule, REGION_SPAWN_RATE);
+        }
+    }
+}
+
+// 开一局：同一个种子决定整个世界（各区域的鱼、鱼群布局）
+void ResetFishGame(uint64_t seed) {
+    player.position = { WORLD_WIDTH / 2, WORLD_HEIGHT / 2 };
+    prevPlayerPosition = player.position;
+    player.radius = 20.0f;
+    gameScore = 0;
+    enemies.count = 0;
+    isGameOver = false;
+    simTicks = 0;
+    simAccumulator = 0;
+    spawnSchedule.rng = seed;
+    ocean.seed = NextScheduleRandom(spawnSchedule);
+    ocean.viewSchedule.rng = NextScheduleRandom(spawnSchedule);
+    ocean.viewSchedule.nextSpawn = 0;
+    ScheduleNextSpawn(ocean.viewSchedule, SPAWN_RATE);
+    ocean.count = 0;
+    ocean.rx1 = ocean.rx0 - 1;
+    flowField.valid = false;
+    UpdateActiveRegions(ocean, ViewRect(player.position), 0.0);
+    // 区域里的鱼不看玩家，开局时把出生点附近清空，免得一上来就被吃
+    for (int i = 0; i < enemies.count; ) {
+        if (Vector2Distance({ enemies.x[i], enemies.y[i] }, player.position) < 200.0f) RemoveEnemy(enemies, i);
+        else i++;
+    }
+    if (schoolMode) SpawnSchool(enemies, SCHOOL_COUNT, (uint32_t)NextScheduleRandom(spawnSchedule), ocean.bounds);
+}
+
+void SetSchoolMode(bool on) {
+    schoolMode = on;
+    if (schoolMode) SpawnSchool(enemies, SCHOOL_COUNT, (uint32_t)NextScheduleRandom(spawnSchedule), ocean.bounds);
+    else ClearSchool(enemies);
+}
+
+// 推进一个固定步长；target 是玩家要游向的点（鼠标或脚本）
+void SimulateTick(Vector2 target) {
+    // 玩家控制：平滑跟随目标
+    prevPlayerPosition = player.position;
+    float follow = 1.0f - expf(-PLAYER_FOLLOW_RATE * SIM_DT);
+    player.position.x += (target.x - player.position.x) * follow;
+    player.position.y += (target.y - player.position.y) * follow;
+    player.position.x = fminf(fmaxf(player.position.x, 0.0f), WORLD_WIDTH);
+    player.position.y = fminf(fmaxf(player.position.y, 0.0f), WORLD_HEIGHT);
+
+    // 尾迹：游得越快，尾巴后面冒的小气泡越多
+    float moved = Vector2Distance(prevPlayerPosition, player.position);
+    if (moved > 1.0f && ParticleRandom(particles, 0.0f, 6.0f) < moved) {
+        float back = (player.position.x >= prevPlayerPosition.x) ? -1.0f : 1.0f;
+        EmitParticle(particles, player.position.x + back * player.radius * 2.0f, player.position.y + ParticleRandom(particles, -4.0f, 4.0f),
+                     back * 20.0f, ParticleRandom(particles, -30.0f, -10.0f), -20.0f, ParticleRandom(particles, 0.6f, 1.2f),
+                     ParticleRandom(particles, 1.0f, 2.5f), { 255, 255, 255, 110 });
+    }
+
+    simTicks++;
+    double now = simTicks * (double)SIM_DT;
+    UpdateActiveRegions(ocean, ViewRect(player.position), now);
+    SpawnFromRegions(ocean, now);
+    UpdateFlowField(flowField, ocean.bounds, player.position, simTicks);
+
+    StepEnemies(enemies, GetFishPool(), player.position, player.radius, SIM_DT, ocean.bounds);
+
+    // 先让敌鱼互吃，再只检测玩家附近格子里的鱼
+    pairsTested = 0;
+    BuildSpatialHash(fishHash, enemies.x, enemies.y, enemies.radius, enemies.count);
+    ResolveFishEating(enemies, fishHash);
+    QuerySpatialHash(fishHash, player.position, player.radius + fishHash.maxRadius, [&](int i) {
+        if (!enemies.active[i] || isGameOver) return;
+        pairsTested++;
+        if (CheckCollisionCircles(player.position, player.radius, { enemies.x[i], enemies.y[i] }, enemies.radius[i])) {
+            if (player.radius >= enemies.radius[i]) {
+                enemies.active[i] = 0;
+                player.radius += EatGrowth(enemies, i, 0.8f);
+                EmitBurst(particles, enemies.x[i], enemies.y[i], GREEN, enemies.behavior[i] == BEHAVIOR_SCHOOL ? 4 : 24);
+                gameScore += enemies.behavior[i] == BEHAVIOR_SCHOOL ? 1 : 10;
             } else {
-                ++it;
+                isGameOver = true;
+                #if defined(PLATFORM_WEB)
+                EM_ASM({
+                    if (typeof window.parent.UpdateWebScore === 'function') window.parent.UpdateWebScore($0);
+                    else if (typeof UpdateWebScore === 'function') UpdateWebScore($0);
+                }, gameScore);
+                #endif
             }
         }
+    });
+
+    ClassifyEnemies(enemies, player.radius);
+    RemoveInactiveEnemies(enemies);
+}
+
+// 两步之间的插值位置；环绕到对边的鱼直接用新位置
+Vector2 LerpFishPosition(float x0, float y0, float x1, float y1, float alpha) {
+    if (fabsf(x1 - x0) > SCREEN_WIDTH / 2 || fabsf(y1 - y0) > SCREEN_HEIGHT / 2) return { x1, y1 };
+    return { x0 + (x1 - x0) * alpha, y0 + (y1 - y0) * alpha };
+}
+
+void UpdateDrawFrame() {
+    BeginParticleFrame(particles);
+    if (!isGameOver) {
+        if (IsKeyPressed(KEY_B)) SetSchoolMode(!schoolMode);
+
+        // 按真实时间攒步数，每步都用同样的 SIM_DT
+        simAccumulator += fminf(GetFrameTime(), MAX_FRAME_TIME);
+        Vector2 mousePos = GetScreenToWorld2D(GetMousePosition(), camera);
+        while (simAccumulator >= SIM_DT && !isGameOver) {
+            SimulateTick(mousePos);
+            simAccumulator -= SIM_DT;
+        }
     } else {
         if (IsKeyPressed(KEY_R) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            player.radius = 20.0f;
-            gameScore = 0;
-            enemies.clear();
-            isGameOver = false;
+            ResetFishGame(((uint64_t)GetRandomValue(0, 0x7FFFFFFF) << 31) ^ (uint64_t)GetRandomValue(0, 0x7FFFFFFF));
         }
     }
+    float alpha = simAccumulator / SIM_DT;
+    Vector2 playerDrawPos = Vector2Lerp(prevPlayerPosition, player.position, alpha);
+    Rectangle view = ViewRect(playerDrawPos);
+    camera.target = { view.x + SCREEN_WIDTH / 2.0f, view.y + SCREEN_HEIGHT / 2.0f };
+    // 粒子纯属装饰，按真实帧时间推进
+    StepParticles(particles, fminf(GetFrameTime(), MAX_FRAME_TIME), view);
 
     BeginDrawing();
-        ClearBackground({ 0, 80, 150, 255 }); // 更深的海洋蓝
+        // 越往下越暗
+        float depth = view.y / (WORLD_HEIGHT - SCREEN_HEIGHT);
+        ClearBackground({ 0, (unsigned char)(80 - 50 * depth), (unsigned char)(150 - 80 * depth), 255 }); // 更深的海洋蓝
 
-        // 绘制背景装饰（小气泡）
-        for(int i=0; i<5; i++) DrawCircle(200*i + (int)(GetTime()*20)%50, 100*i, 2, {255,255,255,50});
+        // 气泡、碎屑和鱼进同一批，一起画
+        BeginMode2D(camera);
+        fishBatch.drawCalls = 0;
+        fishBatch.frameVertices = 0;
+        BatchParticles(fishBatch, particles);
 
         if (!isGameOver) {
             // 绘制敌鱼
-            for (const auto& enemy : enemies) {
-                DrawFish(enemy.position, enemy.radius, enemy.color, enemy.speed);
+            for (int i = 0; i < enemies.count; i++) {
+                Vector2 pos = LerpFishPosition(enemies.prevX[i], enemies.prevY[i], enemies.x[i], enemies.y[i], alpha);
+                BatchFish(fishBatch, pos, enemies.radius[i], enemies.bigger[i] ? RED : GREEN, enemies.speed[i]);
             }
             // 绘制玩家 (默认向右移动)
-            float moveDir = (GetMousePosition().x - player.position.x);
-            DrawFish(player.position, player.radius, player.color, moveDir);
+            float moveDir = (GetScreenToWorld2D(GetMousePosition(), camera).x - player.position.x);
+            BatchFish(fishBatch, playerDrawPos, player.radius, player.color, moveDir);
+        }
+        FlushFishBatch(fishBatch);
+        EndMode2D();
+
+        if (!isGameOver) {
 
             DrawText(TextFormat("SCORE: %d", gameScore), 25, 25, 20, WHITE);
             DrawText(TextFormat("SIZE: %.1f", player.radius), 25, 55, 18, SKYBLUE);
+            long long n = enemies.count;
+            DrawText(TextFormat("FISH: %lld  PAIRS: %lld / %lld  DRAW CALLS: %d (%d verts)", n, pairsTested, n + n * (n - 1) / 2,
+                                fishBatch.drawCalls, fishBatch.frameVertices), 25, SCREEN_HEIGHT - 30, 16, Fade(WHITE, 0.6f));
+            DrawText(TextFormat("PARTICLES: %d / %d  DROPPED: %d", particles.count, PARTICLE_CAPACITY, particles.dropped),
+                     SCREEN_WIDTH - 300, 25, 16, Fade(WHITE, 0.6f));
+            DrawText(TextFormat("REGION %d,%d of %dx%d  ACTIVE %d", (int)(player.position.x / SCREEN_WIDTH), (int)(player.position.y / SCREEN_HEIGHT),
+                                WORLD_REGIONS_X, WORLD_REGIONS_Y, ocean.count), SCREEN_WIDTH - 300, 45, 16, Fade(WHITE, 0.6f));
+            DrawText(TextFormat("FLOW %.2f ms  HUNT %.2f ms  (%d hunters)", flowField.lastBuildMs, schoolTimings.huntMs, schoolTimings.hunters),
+                     25, SCREEN_HEIGHT - 74, 16, Fade(WHITE, 0.6f));
+            if (schoolMode) {
+                DrawText(TextFormat("SCHOOL %d  GRID %.2f ms  STEER %.2f ms  INTEGRATE %.2f ms  (%d threads)",
+                                    schoolCount, schoolTimings.gridMs, schoolTimings.steerMs, schoolTimings.integrateMs,
+                                    GetFishPool().ThreadCount()), 25, SCREEN_HEIGHT - 52, 16, Fade(WHITE, 0.6f));
+            }
         } else {
             DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.85f));
             DrawText("EVO HALTED - CONSUMED", SCREEN_WIDTH/2 - 160, SCREEN_HEIGHT/2 - 40, 30, RED);
@@ -144,14 +1204,243 @@ void UpdateDrawFrame() {
     EndDrawing();
 }
 
-int main() {
+// --- 空间哈希基准（仅本地） ---
+// 随机撒 n 条鱼（密度与正常画面相当），比较网格与两两暴力检测的次数和耗时，
+// 并核对两者找到的重叠对数一致
+void RunHashBenchmark() {
+    const int counts[] = { 1000, 10000, 50000 };
+    printf("%8s %14s %14s %10s %10s %10s\n", "fish", "grid pairs", "naive pairs", "grid ms", "naive ms", "overlaps");
+    for (int n : counts) {
+        uint32_t rng = 2024;
+        auto rnd = [&rng](float lo, float hi) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            return lo + (hi - lo) * ((rng >> 8) * (1.0f / 16777216.0f));
+        };
+        float side = sqrtf((float)n) * 80.0f;
+        std::vector<float> xs(n), ys(n), radii(n);
+        for (int i = 0; i < n; i++) {
+            xs[i] = rnd(0, side);
+            ys[i] = rnd(0, side);
+            radii[i] = rnd(8.0f, 35.0f);
+        }
+
+        SpatialHash h;
+        auto start = std::chrono::steady_clock::now();
+        BuildSpatialHash(h, xs.data(), ys.data(), radii.data(), n);
+        long long gridPairs = 0, gridOverlaps = 0;
+        for (int i = 0; i < n; i++) {
+            QuerySpatialHash(h, { xs[i], ys[i] }, radii[i] + h.maxRadius, [&](int j) {
+                if (j <= i) return;
+                gridPairs++;
+                if (CheckCollisionCircles({ xs[i], ys[i] }, radii[i], { xs[j], ys[j] }, radii[j])) gridOverlaps++;
+            });
+        }
+        double gridMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        long long naivePairs = (long long)n * (n - 1) / 2, naiveOverlaps = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                if (CheckCollisionCircles({ xs[i], ys[i] }, radii[i], { xs[j], ys[j] }, radii[j])) naiveOverlaps++;
+            }
+        }
+        double naiveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%8d %14lld %14lld %10.2f %10.2f %10lld%s\n", n, gridPairs, naivePairs, gridMs, naiveMs, gridOverlaps,
+               gridOverlaps == naiveOverlaps ? "" : "  MISMATCH");
+    }
+}
+
+// --- 鱼群基准（仅本地） ---
+// 固定种子撒 count 条鱼，在 1..maxThreads 个线程下各跑同样帧数，
+// 输出各阶段平均耗时和终态校验和（校验和应与线程数无关）
+void RunSchoolBenchmark(int count, int maxThreads) {
+    if (maxThreads < 1) maxThreads = (int)std::thread::hardware_concurrency();
+    const int FRAMES = 300;
+    static EnemySoA bench;
+    printf("%d fish, %d frames\n", count, FRAMES);
+    printf("%8s %10s %10s %12s %10s %18s\n", "threads", "grid ms", "steer ms", "integrate ms", "total ms", "checksum");
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        WorkerPool pool(threads);
+        bench.count = 0;
+        const Rectangle area = { 0, 0, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT };
+        SpawnSchool(bench, count, 2024, area);
+        SchoolTimings sum;
+        for (int f = 0; f < FRAMES; f++) {
+            StepEnemies(bench, pool, { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f }, 20.0f, SIM_DT, area);
+            sum.gridMs += schoolTimings.gridMs;
+            sum.steerMs += schoolTimings.steerMs;
+            sum.integrateMs += schoolTimings.integrateMs;
+        }
+        uint64_t checksum = 1469598103934665603ull;
+        for (int i = 0; i < bench.count; i++) {
+            uint32_t bits[2];
+            memcpy(&bits[0], &bench.x[i], 4);
+            memcpy(&bits[1], &bench.y[i], 4);
+            checksum = (checksum ^ bits[0]) * 1099511628211ull;
+            checksum = (checksum ^ bits[1]) * 1099511628211ull;
+        }
+        printf("%8d %10.3f %10.3f %12.3f %10.3f %18llx\n", pool.ThreadCount(), sum.gridMs / FRAMES, sum.steerMs / FRAMES,
+               sum.integrateMs / FRAMES, (sum.gridMs + sum.steerMs + sum.integrateMs) / FRAMES, (unsigned long long)checksum);
+    }
+}
+
+// --- 粒子基准（仅本地） ---
+// 把池子灌到 count 个长寿命粒子，测每帧 SIMD 更新和拼顶点的耗时
+void RunParticleBenchmark(int count) {
+    const int FRAMES = 600;
+    static ParticlePool bench;
+    static FishBatch batch;
+    count = std::min(count, PARTICLE_CAPACITY);
+    bench.count = 0;
+    while (bench.count < count) {
+        bench.budget = PARTICLE_BUDGET;
+        float angle = ParticleRandom(bench, 0.0f, 2.0f * PI);
+        EmitParticle(bench, ParticleRandom(bench, 0, SCREEN_WIDTH), ParticleRandom(bench, 0, SCREEN_HEIGHT),
+                     cosf(angle) * 20.0f, sinf(angle) * 20.0f, -4.0f, 1000.0f, 2.0f, WHITE);
+    }
+    double updateMs = 0, batchMs = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        auto t0 = std::chrono::steady_clock::now();
+        UpdateParticles(bench, SIM_DT);
+        auto t1 = std::chrono::steady_clock::now();
+        batch.vertexCount = 0;
+        BatchParticles(batch, bench);
+        auto t2 = std::chrono::steady_clock::now();
+        updateMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        batchMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+    printf("%d particles: update %.3f ms/frame, vertex build %.3f ms/frame, %d verts\n",
+           bench.count, updateMs / FRAMES, batchMs / FRAMES, bench.count * 6);
+}
+
+// --- 追猎基准（仅本地） ---
+// 玩家周围撒 predators 条比玩家大、航向随机的鱼，每步都强制重建流场，分别测流场和猎手转向的耗时；
+// 最后统计开局就在追猎范围内的鱼有多少真的游近了玩家（单列开局背对玩家的那些）
+void RunHuntBenchmark(int predators) {
+    const int TICKS = 600;
+    ResetFishGame(1);
+    enemies.count = 0;
+    player.position = { WORLD_WIDTH / 2.0f, WORLD_HEIGHT / 2.0f };
+    Rectangle area = { player.position.x - 1600.0f, player.position.y - 1200.0f, 3200.0f, 2400.0f };
+    uint32_t rng = 12345;
+    auto rnd = [&rng](float lo, float hi) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return lo + (hi - lo) * ((rng >> 8) * (1.0f / 16777216.0f));
+    };
+    std::vector<float> startDist(predators);
+    std::vector<char> facingAway(predators);
+    for (int i = 0; i < predators; i++) {
+        float x = rnd(area.x, area.x + area.width), y = rnd(area.y, area.y + area.height);
+        float heading = rnd(0.0f, 2.0f * PI);
+        AddEnemy(enemies, x, y, player.radius * 1.5f, 80.0f * cosf(heading), 80.0f * sinf(heading));
+        float dx = player.position.x - x, dy = player.position.y - y;
+        startDist[i] = sqrtf(dx * dx + dy * dy);
+        facingAway[i] = dx * cosf(heading) + dy * sinf(heading) < 0;
+    }
+    ClassifyEnemies(enemies, player.radius);
+    WorkerPool& pool = GetFishPool();
+    double flowMs = 0, huntMs = 0;
+    long long hunters = 0;
+    for (int t = 0; t < TICKS; t++) {
+        // 玩家绕小圈慢游（约 60 像素/秒，比猎手慢），流场仍每步强制重建
+        player.position.x = WORLD_WIDTH / 2.0f + 200.0f * cosf(t * 0.005f);
+        player.position.y = WORLD_HEIGHT / 2.0f + 200.0f * sinf(t * 0.005f);
+        BuildFlowField(flowField, area, player.position);
+        StepEnemies(enemies, pool, player.position, player.radius, SIM_DT, area);
+        flowMs += flowField.lastBuildMs;
+        huntMs += schoolTimings.huntMs;
+        hunters += schoolTimings.hunters;
+    }
+    // 没有吃鱼和清理，下标仍与开局一一对应
+    int inRange = 0, closed = 0, awayInRange = 0, awayClosed = 0;
+    for (int i = 0; i < enemies.count; i++) {
+        if (startDist[i] > HUNT_RANGE * FLOW_CELL) continue;
+        float dx = player.position.x - enemies.x[i], dy = player.position.y - enemies.y[i];
+        bool closer = enemies.active[i] && sqrtf(dx * dx + dy * dy) < startDist[i];
+        inRange++;
+        closed += closer;
+        awayInRange += facingAway[i];
+        awayClosed += facingAway[i] && closer;
+    }
+    printf("%d predators (%d threads): flow field %.3f ms/tick, hunt steer %.3f ms/tick (%.1f ns/fish), %.0f hunting\n",
+           predators, pool.ThreadCount(), flowMs / TICKS, huntMs / TICKS, huntMs / TICKS * 1e6 / std::max(predators, 1),
+           (double)hunters / TICKS);
+    printf("closing: %d of %d predators starting in range ended closer (%d of %d that started facing away)\n",
+           closed, inRange, awayClosed, awayInRange);
+}
+
+// --- 无头快进（仅本地） ---
+// 不开窗口，用脚本路线代替鼠标，按固定步长尽快跑 seconds 模拟秒；
+// 被吃掉就用下一个种子重开。同样的参数两次运行校验和应一致
+void RunFastForward(float seconds, uint64_t seed, bool school) {
+    schoolMode = school;
+    ResetFishGame(seed);
+    long long ticks = (long long)(seconds * SIM_HZ);
+    int deaths = 0, bestScore = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; t++) {
+        float time = t * SIM_DT;
+        // 沿着正弦线在世界里来回巡游，一路穿过许多区域
+        Vector2 target = { player.position.x + 40.0f * (sinf(time * 0.01f) >= 0 ? 1.0f : -1.0f), WORLD_HEIGHT / 2.0f + 1500.0f * sinf(time * 0.05f) };
+        SimulateTick(target);
+        if (isGameOver) {
+            bestScore = std::max(bestScore, gameScore);
+            deaths++;
+            ResetFishGame(seed + deaths);
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    bestScore = std::max(bestScore, gameScore);
+
+    uint64_t checksum = 1469598103934665603ull ^ (uint64_t)gameScore;
+    for (int i = 0; i < enemies.count; i++) {
+        uint32_t bits[2];
+        memcpy(&bits[0], &enemies.x[i], 4);
+        memcpy(&bits[1], &enemies.y[i], 4);
+        checksum = (checksum ^ bits[0]) * 1099511628211ull;
+        checksum = (checksum ^ bits[1]) * 1099511628211ull;
+    }
+    printf("simulated %.0f s (%lld ticks) in %.1f ms, %.0fx realtime\n", seconds, ticks, ms, seconds * 1000.0 / ms);
+    printf("deaths %d, best score %d, fish alive %d, regions activated %lld, checksum %016llx\n", deaths, bestScore, enemies.count,
+           ocean.activations, (unsigned long long)checksum);
+}
+
+int main(int argc, char** argv) {
+#if !defined(PLATFORM_WEB)
+    if (argc > 1 && strcmp(argv[1], "--hash-bench") == 0) {
+        RunHashBenchmark();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--fast-forward") == 0) {
+        RunFastForward(argc > 2 ? (float)atof(argv[2]) : 600.0f, argc > 3 ? strtoull(argv[3], nullptr, 10) : 1,
+                       argc > 4 && atoi(argv[4]) != 0);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--hunt-bench") == 0) {
+        RunHuntBenchmark(argc > 2 ? atoi(argv[2]) : 5000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--particle-bench") == 0) {
+        RunParticleBenchmark(argc > 2 ? atoi(argv[2]) : 50000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--school-bench") == 0) {
+        RunSchoolBenchmark(argc > 2 ? atoi(argv[2]) : SCHOOL_COUNT, argc > 3 ? atoi(argv[3]) : 0);
+        return 0;
+    }
+#endif
+    ReserveSpatialHash(fishHash, MAX_ENEMIES);
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "TinyPulse - Hungry Fish");
+    LoadFishBatch(fishBatch);
+    ResetFishGame(((uint64_t)GetRandomValue(0, 0x7FFFFFFF) << 31) ^ (uint64_t)GetRandomValue(0, 0x7FFFFFFF));
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
     SetTargetFPS(60);
     while (!WindowShouldClose()) UpdateDrawFrame();
 #endif
+    UnloadFishBatch(fishBatch);
     CloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+// 贪吃蛇竞技场、鱼群和扫雷求解共用的常驻线程池。
+// 线程创建一次、每帧复用；Run 阻塞到全部任务完成；Web 端没有开 pthread，退化为单线程
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class WorkerPool {
+public:
+    explicit WorkerPool(int threadCount) {
+#if defined(PLATFORM_WEB)
+        threadCount = 1;
+#endif
+        for (int i = 1; i < threadCount; i++) workers.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    int ThreadCount() const { return (int)workers.size() + 1; }
+
+    // 把 fn(0) ... fn(taskCount - 1) 分给所有线程（含调用线程）执行
+    void Run(int taskCount, const std::function<void(int)>& fn) {
+        if (workers.empty() || taskCount <= 1) {
+            for (int i = 0; i < taskCount; i++) fn(i);
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            idle.wait(lock, [this] { return busy == 0; });
+            job = &fn;
+            jobCount = taskCount;
+            pending = taskCount;
+            nextTask = 0;
+            generation++;
+        }
+        wake.notify_all();
+        Drain();
+        std::unique_lock<std::mutex> lock(mtx);
+        idle.wait(lock, [this] { return pending == 0 && busy == 0; });
+    }
+
+private:
+    void Drain() {
+        for (;;) {
+            int i = nextTask.fetch_add(1);
+            if (i >= jobCount) return;
+            (*job)(i);
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mtx);
+                idle.notify_all();
+            }
+        }
+    }
+
+    void WorkerLoop() {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            busy++;
+            lock.unlock();
+            Drain();
+            lock.lock();
+            if (--busy == 0) idle.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable wake, idle;
+    const std::function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    int busy = 0;
+    unsigned generation = 0;
+    bool stopping = false;
+    std::atomic<int> nextTask{0};
+    std::atomic<int> pending{0};
+};
+
+#endif // WORKER_POOL_H
@@ -1,53 +1,75 @@
 #include "include/raylib.h"
+#include "include/raymath.h"
+#include "include/rlgl.h"
+#include "include/worker_pool.h"
 #include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
 #endif
 
-// --- 经典 9x9 规格 ---
+// --- 屏幕与棋盘规格 ---
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
-const int COLS = 9;
-const int ROWS = 9;
-const int CELL_SIZE = 60; 
-const int OFFSET_X = (SCREEN_WIDTH - (COLS * CELL_SIZE)) / 2;
-const int OFFSET_Y = (SCREEN_HEIGHT - (ROWS * CELL_SIZE)) / 2;
-
-struct Cell {
-    bool isMine = false;
-    bool isRevealed = false;
-    bool isFlagged = false;
-    int neighborCount = 0;
+const int MAX_CELL_SIZE = 60;
+const int MIN_CELL_SIZE = 12;       // 大棋盘不再整盘塞进屏幕，格子缩到这么小就改用镜头平移
+const float MIN_SCREEN_CELL = 4.0f; // 缩小时一格在屏幕上至少这么多像素，限住可见格子数
+const int MAX_BOARD_SIDE = 20000;   // 行列上限，保证 cols * rows 放得进 int
+
+// 每格一个字节：低 4 位是周围雷数，高位是雷 / 翻开 / 插旗
+#define CELL_COUNT_MASK 0x0F
+#define CELL_MINE 0x10
+#define CELL_REVEALED 0x20
+#define CELL_FLAGGED 0x40
+
+// 棋盘按行优先存一整块：cells[y * cols + x]，一行扫过去就是连续内存；
+// 10000x10000 的棋盘约 100 MB
+struct Board {
+    int cols = 0, rows = 0, mines = 0;
+    std::vector<uint8_t> cells;
 };
 
+// 按 1/2/3 切换的经典难度；桌面端还可以用 --board 指定任意尺寸
+struct BoardPreset { int cols, rows, mines; };
+const BoardPreset PRESETS[] = { { 9, 9, 10 }, { 16, 16, 40 }, { 30, 16, 99 } };
+
 // --- 全局变量 ---
-Cell grid[COLS][ROWS];
+Board board;
+BoardPreset boardSize = PRESETS[0];
 bool isGameOver = false;
 bool isWin = false;
-int minesCount = 10; 
+int safeHidden = 0;              // 还没翻开的非雷格数，归零即胜利
+std::vector<int> revealStack;    // 展开用的显式栈，存格子下标，复用不反复分配
+int cellSize = MAX_CELL_SIZE;    // 世界坐标里一格的边长，按棋盘大小缩放
+Camera2D camera = { 0 };         // 两种模式共用的镜头，可平移缩放
+int boardVersion = 0;            // 棋盘每变一次加一，求解提示按需重算
+uint64_t mineRng = 1;
 
 // 检查坐标有效性
 bool IsValid(int x, int y) {
-    return x >= 0 && x < COLS && y >= 0 && y < ROWS;
+    return x >= 0 && x < board.cols && y >= 0 && y < board.rows;
 }
 
-// 检查胜利判定：遍历所有格子，如果没有“未翻开的非雷格”，即为胜利
-void CheckWin() {
-    if (isGameOver) return; // 已失败则不检查胜利
+uint8_t& CellAt(int x, int y) {
+    return board.cells[(size_t)y * board.cols + x];
+}
 
-    bool hasSafeHidden = false;
-    for (int x = 0; x < COLS; x++) {
-        for (int y = 0; y < ROWS; y++) {
-            if (!grid[x][y].isMine && !grid[x][y].isRevealed) {
-                hasSafeHidden = true;
-                break;
-            }
-        }
-        if (hasSafeHidden) break;
-    }
+// 检查胜利判定：翻开非雷格时 safeHidden 递减，这里只比一下计数
+void CheckWin() {
+    if (isGameOver || isWin) return; // 已失败或已胜利则不再检查
 
-    if (!hasSafeHidden) {
+    if (safeHidden == 0) {
         isWin = true;
         #if defined(PLATFORM_WEB)
         // 胜利时向主门户提交一个高分
@@ -56,113 +78,1154 @@ void CheckWin() {
     }
 }
 
-// 递归展开 (Flood Fill)
+// 展开 (Flood Fill)：用显式栈代替递归，大片空白也不会爆栈；
+// 入栈前就标记翻开，每个格子只处理一次，整次展开是 O(翻开格数)
 void RevealCell(int x, int y) {
-    if (!IsValid(x, y) || grid[x][y].isRevealed || grid[x][y].isFlagged) return;
+    if (!IsValid(x, y) || (CellAt(x, y) & (CELL_REVEALED | CELL_FLAGGED))) return;
 
-    grid[x][y].isRevealed = true;
+    const int cols = board.cols;
+    uint8_t* cells = board.cells.data();
+    revealStack.clear();
+    cells[y * cols + x] |= CELL_REVEALED;
+    revealStack.push_back(y * cols + x);
+    while (!revealStack.empty()) {
+        int index = revealStack.back();
+        revealStack.pop_back();
+        if (!(cells[index] & CELL_MINE)) safeHidden--;
 
-    // 如果是数字 0，则递归周围 8 个格子
-    if (grid[x][y].neighborCount == 0 && !grid[x][y].isMine) {
-        for (int i = -1; i <= 1; i++) {
+        // 如果是数字 0，则把周围 8 个格子入栈
+        if (cells[index] & (CELL_MINE | CELL_COUNT_MASK)) continue;
+        int cx = index % cols, cy = index / cols;
+        for (int j = -1; j <= 1; j++) {
+            for (int i = -1; i <= 1; i++) {
+                int nx = cx + i, ny = cy + j;
+                if (!IsValid(nx, ny)) continue;
+                uint8_t& n = cells[ny * cols + nx];
+                if (n & (CELL_REVEALED | CELL_FLAGGED)) continue;
+                n |= CELL_REVEALED;
+                revealStack.push_back(ny * cols + nx);
+            }
+        }
+    }
+
+    CheckWin(); // 整次展开结束后检查一次胜利
+}
+
+// splitmix64：大棋盘的格子数超过 GetRandomValue 的范围，布雷用自己的随机数
+uint64_t NextMineRandom() {
+    uint64_t z = (mineRng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// --- 邻雷计数 ---
+// 逐格 3x3 查找的原始写法，留作基准和对照
+void CountNeighborsScalar(Board& b) {
+    for (int y = 0; y < b.rows; y++) {
+        for (int x = 0; x < b.cols; x++) {
+            uint8_t& cell = b.cells[(size_t)y * b.cols + x];
+            cell &= ~CELL_COUNT_MASK;
+            if (cell & CELL_MINE) continue;
+            int count = 0;
             for (int j = -1; j <= 1; j++) {
-                if (i != 0 || j != 0) RevealCell(x + i, y + j);
+                for (int i = -1; i <= 1; i++) {
+                    int nx = x + i, ny = y + j;
+                    if (nx >= 0 && nx < b.cols && ny >= 0 && ny < b.rows && (b.cells[(size_t)ny * b.cols + nx] & CELL_MINE)) count++;
+                }
+            }
+            cell |= (uint8_t)count;
+        }
+    }
+}
+
+// 把一行格子的雷位压成位平面：每 64 格一个 uint64，第 i 位是第 i 格
+void PackMineRow(const uint8_t* row, int cols, uint64_t* bits) {
+    int words = (cols + 63) / 64;
+    for (int w = 0; w < words; w++) bits[w] = 0;
+    int x = 0;
+    for (; x + 8 <= cols; x += 8) {
+        uint64_t v;
+        memcpy(&v, row + x, 8);
+        // 每个字节取出雷位放到最低位，再用乘法把 8 个字节的最低位收拢到最高字节
+        uint64_t m = (v >> 4) & 0x0101010101010101ull;
+        bits[x >> 6] |= ((m * 0x0102040810204080ull) >> 56) << (x & 63);
+    }
+    for (; x < cols; x++) {
+        if (row[x] & CELL_MINE) bits[x >> 6] |= 1ull << (x & 63);
+    }
+}
+
+// 位切片的 3x3 求和：上中下三行先竖着加成 2 位数（s0, s1），
+// 再把左中右三列横着加成 4 位数（b0..b3），一次处理 64 格。
+// 非雷格中心不是雷，3x3 的和就是邻雷数；雷格的计数清零。
+// 最后用查表把 64 位的各个位平面展开成 64 个字节写回
+void CountNeighbors(Board& b) {
+    static uint64_t spread[256];            // 8 位展开成 8 个字节的 0/1
+    static bool spreadReady = false;
+    if (!spreadReady) {
+        for (int v = 0; v < 256; v++) {
+            spread[v] = 0;
+            for (int k = 0; k < 8; k++) if (v & (1 << k)) spread[v] |= 1ull << (k * 8);
+        }
+        spreadReady = true;
+    }
+    static std::vector<uint64_t> planes;    // 滚动的三行雷位，外加一行全零
+    int words = (b.cols + 63) / 64;
+    planes.assign((size_t)words * 4, 0);
+    uint64_t* zero = &planes[(size_t)words * 3];
+    uint64_t* rowBits[3] = { &planes[0], &planes[words], &planes[(size_t)words * 2] };
+    PackMineRow(&b.cells[0], b.cols, rowBits[1]);
+    if (b.rows > 1) PackMineRow(&b.cells[b.cols], b.cols, rowBits[2]);
+
+    for (int y = 0; y < b.rows; y++) {
+        const uint64_t* up = y > 0 ? rowBits[0] : zero;
+        const uint64_t* mid = rowBits[1];
+        const uint64_t* down = y + 1 < b.rows ? rowBits[2] : zero;
+        uint8_t* row = &b.cells[(size_t)y * b.cols];
+        uint64_t prev0 = 0, prev1 = 0;      // 左边一个字的竖向和，用来补移位进来的那一位
+        uint64_t c0 = up[0] ^ mid[0] ^ down[0];
+        uint64_t c1 = (up[0] & mid[0]) | (down[0] & (up[0] ^ mid[0]));
+        for (int w = 0; w < words; w++) {
+            uint64_t n0 = 0, n1 = 0;
+            if (w + 1 < words) {
+                n0 = up[w + 1] ^ mid[w + 1] ^ down[w + 1];
+                n1 = (up[w + 1] & mid[w + 1]) | (down[w + 1] & (up[w + 1] ^ mid[w + 1]));
+            }
+            // 左邻（x-1）和右邻（x+1）的竖向和
+            uint64_t l0 = (c0 << 1) | (prev0 >> 63), l1 = (c1 << 1) | (prev1 >> 63);
+            uint64_t r0 = (c0 >> 1) | (n0 << 63), r1 = (c1 >> 1) | (n1 << 63);
+            // 权 1 位：三个相加，进位到权 2
+            uint64_t b0 = l0 ^ c0 ^ r0;
+            uint64_t k1 = (l0 & c0) | (r0 & (l0 ^ c0));
+            // 权 2 位：l1 + c1 + r1 + k1
+            uint64_t u0 = l1 ^ c1 ^ r1;
+            uint64_t u1 = (l1 & c1) | (r1 & (l1 ^ c1));
+            uint64_t b1 = u0 ^ k1;
+            uint64_t k2 = u0 & k1;
+            // 权 4、权 8 位
+            uint64_t b2 = u1 ^ k2;
+            uint64_t b3 = u1 & k2;
+            uint64_t mine = mid[w];
+            b0 &= ~mine; b1 &= ~mine; b2 &= ~mine; b3 &= ~mine;
+
+            int x0 = w * 64, span = b.cols - x0 < 64 ? b.cols - x0 : 64;
+            for (int k = 0; k < span; k += 8) {
+                uint64_t bytes = spread[(b0 >> k) & 0xFF] | (spread[(b1 >> k) & 0xFF] << 1) |
+                                 (spread[(b2 >> k) & 0xFF] << 2) | (spread[(b3 >> k) & 0xFF] << 3) |
+                                 (spread[(mine >> k) & 0xFF] << 4);
+                if (span - k >= 8) {
+                    memcpy(row + x0 + k, &bytes, 8);
+                } else {
+                    for (int t = 0; t < span - k; t++) row[x0 + k + t] = (uint8_t)(bytes >> (t * 8));
+                }
             }
+            prev0 = c0; prev1 = c1;
+            c0 = n0; c1 = n1;
         }
+
+        // 三行往上滚一行，新的一行压进最下面
+        uint64_t* recycled = rowBits[0];
+        rowBits[0] = rowBits[1];
+        rowBits[1] = rowBits[2];
+        rowBits[2] = recycled;
+        if (y + 2 < b.rows) PackMineRow(&b.cells[(size_t)(y + 2) * b.cols], b.cols, rowBits[2]);
     }
-    
-    CheckWin(); // 每次递归翻开都触发一次胜利检查
+}
+
+// 按棋盘大小算格子边长，镜头对准棋盘中心；放不下的大棋盘从中间开始看
+void LayoutBoard() {
+    cellSize = MAX_CELL_SIZE;
+    if (board.cols * cellSize > SCREEN_WIDTH - 40) cellSize = (SCREEN_WIDTH - 40) / board.cols;
+    if (board.rows * cellSize > SCREEN_HEIGHT - 60) cellSize = (SCREEN_HEIGHT - 60) / board.rows;
+    if (cellSize < MIN_CELL_SIZE) cellSize = MIN_CELL_SIZE;
+    camera.offset = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
+    camera.target = { board.cols * cellSize / 2.0f, board.rows * cellSize / 2.0f };
+    camera.zoom = 1.0f;
 }
 
 void ResetGame() {
     isGameOver = false;
     isWin = false;
-    for (int x = 0; x < COLS; x++) {
-        for (int y = 0; y < ROWS; y++) grid[x][y] = Cell();
-    }
+    board.cols = boardSize.cols;
+    board.rows = boardSize.rows;
+    int total = board.cols * board.rows;
+    board.mines = boardSize.mines < total ? boardSize.mines : total - 1;
+    board.cells.assign(total, 0);
+    safeHidden = total - board.mines;
+    boardVersion++;
+    LayoutBoard();
 
+    mineRng = ((uint64_t)GetRandomValue(0, 0x7FFF) << 15) ^ (uint64_t)GetRandomValue(0, 0x7FFF);
     int placedMines = 0;
-    while (placedMines < minesCount) {
-        int rx = GetRandomValue(0, COLS - 1);
-        int ry = GetRandomValue(0, ROWS - 1);
-        if (!grid[rx][ry].isMine) {
-            grid[rx][ry].isMine = true;
+    while (placedMines < board.mines) {
+        int index = (int)(NextMineRandom() % (uint64_t)total);
+        if (!(board.cells[index] & CELL_MINE)) {
+            board.cells[index] |= CELL_MINE;
             placedMines++;
         }
     }
 
-    for (int x = 0; x < COLS; x++) {
-        for (int y = 0; y < ROWS; y++) {
-            if (grid[x][y].isMine) continue;
-            int count = 0;
+    CountNeighbors(board);
+}
+
+// --- 无限模式：32x32 的块按 (种子, 块坐标) 哈希生成，第一次看到或翻到时才创建 ---
+// 每格是不是雷只由种子和坐标决定，纯整数运算，任何机器上同一种子的地图都一样。
+// 没被玩家动过的块随时可以丢掉再生成，放在 LRU 链表里、超过上限就淘汰最久没用的；
+// 翻开或插过旗的块记为已改动，一直保留，所以内存只随探索过的面积增长
+const int CHUNK_SIZE = 32;
+const int CHUNK_SHIFT = 5;
+const int INFINITE_MINES_PER_1024 = 164;  // 雷密度约 16%
+const int MAX_CLEAN_CHUNKS = 4096;        // 未改动块的缓存上限（约 4 MB）
+const float INFINITE_CELL = 32.0f;        // 世界坐标里一格的边长
+const float MAX_ZOOM = 3.0f;
+
+struct Chunk {
+    uint8_t cells[CHUNK_SIZE * CHUNK_SIZE];
+    bool modified = false;                // 玩家翻开或插过旗，不能丢
+    std::list<int64_t>::iterator lru;     // 未改动时在 cleanLru 里的位置
+};
+
+struct InfiniteWorld {
+    uint64_t seed = 1;
+    std::unordered_map<int64_t, std::unique_ptr<Chunk>> chunks;
+    std::list<int64_t> cleanLru;          // 未改动的块，最近用过的在前面
+    int modifiedChunks = 0;
+    long long generated = 0, evicted = 0;
+    int revealed = 0;                     // 翻开的格子数，即无限模式的得分
+};
+
+bool infiniteMode = false;
+InfiniteWorld world;
+std::vector<int64_t> infiniteStack;      // 无限模式的展开栈，存打包的 (x, y)
+
+int64_t ChunkKey(int cx, int cy) {
+    return (int64_t)(((uint64_t)(uint32_t)cy << 32) | (uint32_t)cx);
+}
+
+uint64_t MixHash(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t ChunkSeed(uint64_t seed, int cx, int cy) {
+    return MixHash(seed ^ MixHash((uint64_t)(uint32_t)cx * 0x9E3779B97F4A7C15ull ^ (uint64_t)(uint32_t)cy));
+}
+
+// 起点周围 3x3 不放雷，开局翻开原点必定是一片空地
+bool MineAt(uint64_t seed, int x, int y) {
+    if (x >= -1 && x <= 1 && y >= -1 && y <= 1) return false;
+    uint64_t h = MixHash(ChunkSeed(seed, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT) + (uint64_t)(((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1))) * 0x9E3779B97F4A7C15ull);
+    return (int)(h >> 54) < INFINITE_MINES_PER_1024;
+}
+
+// 生成一块：先算出带一圈边的 34x34 雷位（边上那圈属于邻块，同样直接哈希），再数邻雷
+void GenerateChunk(const InfiniteWorld& w, Chunk& chunk, int cx, int cy) {
+    const int SPAN = CHUNK_SIZE + 2;
+    uint8_t mines[SPAN * SPAN];
+    int x0 = cx * CHUNK_SIZE - 1, y0 = cy * CHUNK_SIZE - 1;
+    for (int j = 0; j < SPAN; j++)
+        for (int i = 0; i < SPAN; i++) mines[j * SPAN + i] = MineAt(w.seed, x0 + i, y0 + j);
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            const uint8_t* m = &mines[(y + 1) * SPAN + x + 1];
+            if (*m) {
+                chunk.cells[y * CHUNK_SIZE + x] = CELL_MINE;
+                continue;
+            }
+            int count = m[-SPAN - 1] + m[-SPAN] + m[-SPAN + 1] + m[-1] + m[1] + m[SPAN - 1] + m[SPAN] + m[SPAN + 1];
+            chunk.cells[y * CHUNK_SIZE + x] = (uint8_t)count;
+        }
+    }
+}
+
+// 取一块，不存在就生成；未改动的块挪到 LRU 最前，缓存超限时从最后淘汰
+Chunk& GetChunk(InfiniteWorld& w, int cx, int cy) {
+    int64_t key = ChunkKey(cx, cy);
+    auto it = w.chunks.find(key);
+    if (it != w.chunks.end()) {
+        Chunk& chunk = *it->second;
+        if (!chunk.modified) w.cleanLru.splice(w.cleanLru.begin(), w.cleanLru, chunk.lru);
+        return chunk;
+    }
+    while ((int)w.cleanLru.size() >= MAX_CLEAN_CHUNKS) {
+        w.chunks.erase(w.cleanLru.back());
+        w.cleanLru.pop_back();
+        w.evicted++;
+    }
+    Chunk& chunk = *w.chunks.emplace(key, std::unique_ptr<Chunk>(new Chunk())).first->second;
+    GenerateChunk(w, chunk, cx, cy);
+    w.cleanLru.push_front(key);
+    chunk.lru = w.cleanLru.begin();
+    w.generated++;
+    return chunk;
+}
+
+// 玩家要改这块了：移出 LRU，以后不再淘汰
+void MarkModified(InfiniteWorld& w, Chunk& chunk) {
+    if (chunk.modified) return;
+    chunk.modified = true;
+    w.cleanLru.erase(chunk.lru);
+    w.modifiedChunks++;
+}
+
+// 取一格准备修改
+uint8_t& ModifyCell(InfiniteWorld& w, int x, int y) {
+    Chunk& chunk = GetChunk(w, x >> CHUNK_SHIFT, y >> CHUNK_SHIFT);
+    MarkModified(w, chunk);
+    return chunk.cells[((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1))];
+}
+
+int64_t PackCoord(int x, int y) {
+    return (int64_t)(((uint64_t)(uint32_t)y << 32) | (uint32_t)x);
+}
+
+// 无限模式的展开：和棋盘模式同一套显式栈，跨块时由 GetChunk 按需生成邻块
+void RevealInfinite(InfiniteWorld& w, int x, int y) {
+    uint8_t& start = ModifyCell(w, x, y);
+    if (start & (CELL_REVEALED | CELL_FLAGGED)) return;
+    if (start & CELL_MINE) {
+        start |= CELL_REVEALED;
+        isGameOver = true;
+        #if defined(PLATFORM_WEB)
+        // 踩雷时提交翻开的格子数
+        EM_ASM({ if (window.parent && window.parent.UpdateWebScore) window.parent.UpdateWebScore($0); }, w.revealed);
+        #endif
+        return;
+    }
+
+    infiniteStack.clear();
+    start |= CELL_REVEALED;
+    infiniteStack.push_back(PackCoord(x, y));
+    while (!infiniteStack.empty()) {
+        int64_t packed = infiniteStack.back();
+        infiniteStack.pop_back();
+        int cx = (int)(uint32_t)packed, cy = (int)(packed >> 32);
+        w.revealed++;
+        if (ModifyCell(w, cx, cy) & CELL_COUNT_MASK) continue;
+        for (int j = -1; j <= 1; j++) {
             for (int i = -1; i <= 1; i++) {
-                for (int j = -1; j <= 1; j++) {
-                    if (IsValid(x + i, y + j) && grid[x + i][y + j].isMine) count++;
+                uint8_t& n = ModifyCell(w, cx + i, cy + j);
+                if (n & (CELL_REVEALED | CELL_FLAGGED)) continue;
+                n |= CELL_REVEALED;
+                infiniteStack.push_back(PackCoord(cx + i, cy + j));
+            }
+        }
+    }
+}
+
+// 换一个种子开新的无限地图，镜头回到原点并翻开起点
+void ResetInfinite(uint64_t seed) {
+    isGameOver = false;
+    isWin = false;
+    world.chunks.clear();
+    world.cleanLru.clear();
+    world.seed = seed;
+    world.modifiedChunks = 0;
+    world.generated = world.evicted = 0;
+    world.revealed = 0;
+    camera.offset = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
+    camera.target = { INFINITE_CELL / 2, INFINITE_CELL / 2 };
+    camera.zoom = 1.0f;
+    RevealInfinite(world, 0, 0);
+}
+
+uint64_t RandomSeed() {
+    return ((uint64_t)GetRandomValue(0, 0x7FFF) << 30) ^ ((uint64_t)GetRandomValue(0, 0x7FFF) << 15) ^ (uint64_t)GetRandomValue(0, 0x7FFF);
+}
+
+// 切换棋盘尺寸并开新局
+void SelectBoard(BoardPreset preset) {
+    infiniteMode = false;
+    boardSize = preset;
+    ResetGame();
+}
+
+// 翻开一格：踩雷就结束并亮出所有雷，否则展开
+void OpenCell(int x, int y) {
+    if (!IsValid(x, y) || (CellAt(x, y) & CELL_FLAGGED)) return;
+    if (CellAt(x, y) & CELL_MINE) {
+        isGameOver = true;
+        // 游戏结束，翻开所有地雷给玩家看
+        for (uint8_t& cell : board.cells)
+            if (cell & CELL_MINE) cell |= CELL_REVEALED;
+    } else {
+        RevealCell(x, y);
+    }
+}
+
+// --- 常驻线程池（include/worker_pool.h）：求解时各连通块并行穷举 ---
+WorkerPool& GetMinesPool() {
+    static WorkerPool pool((int)std::thread::hardware_concurrency());
+    return pool;
+}
+
+// --- 求解器 ---
+// 只看已翻开的数字（玩家插的旗不算数），挨着数字的未知格叫边界格：
+// 1. 单格约束：还差 0 个雷则周围未知格全安全，差的雷数等于未知格数则全是雷；
+// 2. 子集/重叠：两个约束共享格子时，若 B 比 A 多要的雷数正好等于 B\A 的格数，
+//    则 B\A 全是雷、A\B 全安全；1、2 交替做到不动为止；
+// 3. 剩下的边界格按共享约束分成互不相干的连通块，各块在线程池上并行穷举，
+//    按块内雷数 k 记下解数和每格是雷的解数；
+// 4. 用剩余总雷数把各块拼起来：不挨数字的内部格有 C(I, R - t) 种摆法作权重，得出每格是雷的概率。
+//    边界格太多时卷积太贵，改按估计密度给每个 k 加权，各块独立算
+#define SOLVER_MAX_COMPONENT 64        // 超过这么多格的连通块不穷举，用局部估计
+#define SOLVER_NODE_BUDGET (1 << 20)   // 单块穷举的搜索节点上限，超了也改用局部估计
+#define SOLVER_EXACT_FRONTIER 256      // 穷举的边界格总数不超过这么多时做精确的全局雷数加权
+#define SOLVER_UNKNOWN -1
+
+struct SolverConstraint {
+    int cells[8];           // 边界格编号
+    int count = 0;
+    int mines = 0;          // 数字本身，即这些格子里的雷数
+};
+
+struct SolverComponent {
+    std::vector<int> cells;             // 边界格编号
+    std::vector<int> constraints;
+    bool exact = false;                 // 穷举完成；否则用 estimate
+    std::vector<double> ways;           // ways[k]：块内恰好 k 个雷的解数
+    std::vector<double> mineWays;       // mineWays[k * n + i]：其中第 i 格是雷的解数
+    std::vector<float> estimate;        // 没穷举时每格的局部估计
+};
+
+struct SolveResult {
+    std::vector<int> safe, mines;       // 确定安全 / 确定是雷的格子（棋盘下标）
+    std::vector<int> frontier;          // 其余边界格
+    std::vector<float> probability;     // 与 frontier 一一对应，是雷的概率
+    float interiorProbability = 0;      // 不挨数字的未知格是雷的概率
+    int interiorCount = 0;
+    int components = 0, enumerated = 0;
+    bool globalExact = false;           // 是否按剩余总雷数精确加权
+};
+
+struct MineSolver {
+    std::unordered_map<int, int> idOf;  // 棋盘下标 -> 边界格编号
+    std::vector<int> boardIndex;        // 边界格编号 -> 棋盘下标
+    std::vector<int8_t> state;          // SOLVER_UNKNOWN / 0 安全 / 1 雷
+    std::vector<SolverConstraint> constraints;
+    std::vector<std::vector<int>> cellConstraints;
+    std::vector<int> queue, seenBy, parent;
+    std::vector<char> queued;
+    std::vector<SolverComponent> components;
+};
+
+MineSolver mineSolver;
+
+// 约束里还没定的格子和还差的雷数
+int ReduceConstraint(const MineSolver& s, const SolverConstraint& c, int* unknown, int& unknownCount) {
+    int need = c.mines;
+    unknownCount = 0;
+    for (int k = 0; k < c.count; k++) {
+        int v = s.state[c.cells[k]];
+        if (v == SOLVER_UNKNOWN) unknown[unknownCount++] = c.cells[k];
+        else need -= v;
+    }
+    return need;
+}
+
+void SolverSetCell(MineSolver& s, int id, int value) {
+    if (s.state[id] != SOLVER_UNKNOWN) return;
+    s.state[id] = (int8_t)value;
+    for (int c : s.cellConstraints[id]) {
+        if (!s.queued[c]) {
+            s.queued[c] = 1;
+            s.queue.push_back(c);
+        }
+    }
+}
+
+// 规则 1，做到队列清空
+void PropagateSingles(MineSolver& s) {
+    int unknown[8], unknownCount;
+    while (!s.queue.empty()) {
+        int c = s.queue.back();
+        s.queue.pop_back();
+        s.queued[c] = 0;
+        int need = ReduceConstraint(s, s.constraints[c], unknown, unknownCount);
+        if (unknownCount == 0) continue;
+        if (need == 0) for (int k = 0; k < unknownCount; k++) SolverSetCell(s, unknown[k], 0);
+        else if (need == unknownCount) for (int k = 0; k < unknownCount; k++) SolverSetCell(s, unknown[k], 1);
+    }
+}
+
+// 规则 2，扫一遍所有共享格子的约束对；有新结论返回 true
+bool PropagatePairs(MineSolver& s) {
+    bool changed = false;
+    int ua[8], ub[8], onlyA[8], onlyB[8];
+    int na, nb;
+    std::fill(s.seenBy.begin(), s.seenBy.end(), -1);
+    for (int a = 0; a < (int)s.constraints.size(); a++) {
+        ReduceConstraint(s, s.constraints[a], ua, na);
+        for (int k = 0; k < na; k++) {
+            for (int b : s.cellConstraints[ua[k]]) {
+                if (b <= a || s.seenBy[b] == a) continue;
+                s.seenBy[b] = a;
+                int needA = ReduceConstraint(s, s.constraints[a], ua, na);
+                int needB = ReduceConstraint(s, s.constraints[b], ub, nb);
+                int countA = 0, countB = 0;
+                for (int i = 0; i < na; i++) if (std::find(ub, ub + nb, ua[i]) == ub + nb) onlyA[countA++] = ua[i];
+                for (int i = 0; i < nb; i++) if (std::find(ua, ua + na, ub[i]) == ua + na) onlyB[countB++] = ub[i];
+                if (countA + countB == 0) continue;
+                const int* mineSide = nullptr;
+                const int* safeSide = nullptr;
+                int mineCount = 0, safeCount = 0;
+                if (needB - needA == countB) { mineSide = onlyB; mineCount = countB; safeSide = onlyA; safeCount = countA; }
+                else if (needA - needB == countA) { mineSide = onlyA; mineCount = countA; safeSide = onlyB; safeCount = countB; }
+                else continue;
+                for (int i = 0; i < mineCount; i++) SolverSetCell(s, mineSide[i], 1);
+                for (int i = 0; i < safeCount; i++) SolverSetCell(s, safeSide[i], 0);
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+int FindRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+// 穷举一个连通块：格子按编号顺序逐个试 0 / 1，每步检查涉及的约束还能不能满足
+struct ComponentEnumerator {
+    SolverComponent* comp;
+    std::vector<std::vector<int>> cellCons;     // 块内格子 -> 块内约束
+    std::vector<int> need, assigned, left;
+    std::vector<uint8_t> value;
+    long long nodes = 0;
+    bool aborted = false;
+
+    void Dfs(int i, int mines) {
+        if (++nodes > SOLVER_NODE_BUDGET) { aborted = true; return; }
+        int n = (int)comp->cells.size();
+        if (i == n) {
+            comp->ways[mines] += 1;
+            for (int j = 0; j < n; j++) if (value[j]) comp->mineWays[(size_t)mines * n + j] += 1;
+            return;
+        }
+        for (int v = 0; v <= 1 && !aborted; v++) {
+            bool ok = true;
+            for (int c : cellCons[i]) {
+                int a = assigned[c] + v;
+                if (a > need[c] || a + left[c] - 1 < need[c]) { ok = false; break; }
+            }
+            if (!ok) continue;
+            for (int c : cellCons[i]) { assigned[c] += v; left[c]--; }
+            value[i] = (uint8_t)v;
+            Dfs(i + 1, mines + v);
+            for (int c : cellCons[i]) { assigned[c] -= v; left[c]++; }
+        }
+    }
+};
+
+void EnumerateComponent(const MineSolver& s, SolverComponent& comp) {
+    int n = (int)comp.cells.size();
+    comp.exact = false;
+    comp.estimate.assign(n, 0.0f);
+    std::unordered_map<int, int> local;
+    for (int i = 0; i < n; i++) local[comp.cells[i]] = i;
+    ComponentEnumerator e;
+    e.comp = &comp;
+    e.cellCons.resize(n);
+    int unknown[8], unknownCount;
+    for (int c = 0; c < (int)comp.constraints.size(); c++) {
+        int need = ReduceConstraint(s, s.constraints[comp.constraints[c]], unknown, unknownCount);
+        e.need.push_back(need);
+        e.assigned.push_back(0);
+        e.left.push_back(unknownCount);
+        for (int k = 0; k < unknownCount; k++) {
+            int i = local[unknown[k]];
+            e.cellCons[i].push_back(c);
+            // 局部估计：各约束平均下来的雷密度
+            comp.estimate[i] += (float)need / unknownCount;
+        }
+    }
+    for (int i = 0; i < n; i++) comp.estimate[i] /= std::max((int)e.cellCons[i].size(), 1);
+    if (n > SOLVER_MAX_COMPONENT) return;
+
+    comp.ways.assign(n + 1, 0.0);
+    comp.mineWays.assign((size_t)(n + 1) * n, 0.0);
+    e.value.assign(n, 0);
+    e.Dfs(0, 0);
+    comp.exact = !e.aborted;
+}
+
+// ln C(n, k)
+double LogChoose(int n, int k) {
+    return lgamma(n + 1.0) - lgamma(k + 1.0) - lgamma(n - k + 1.0);
+}
+
+void SolveBoard(const Board& b, WorkerPool& pool, SolveResult& out) {
+    MineSolver& s = mineSolver;
+    out = SolveResult();
+    s.idOf.clear();
+    s.boardIndex.clear();
+    s.constraints.clear();
+
+    // 扫一遍棋盘：每个翻开的数字是一条约束，挨着它的未知格编成边界格
+    int hidden = 0;
+    for (int y = 0; y < b.rows; y++) {
+        const uint8_t* row = &b.cells[(size_t)y * b.cols];
+        for (int x = 0; x < b.cols; x++) {
+            uint8_t cell = row[x];
+            if (!(cell & CELL_REVEALED)) { hidden++; continue; }
+            if ((cell & CELL_MINE) || !(cell & CELL_COUNT_MASK)) continue;
+            SolverConstraint c;
+            c.mines = cell & CELL_COUNT_MASK;
+            for (int j = -1; j <= 1; j++) {
+                for (int i = -1; i <= 1; i++) {
+                    int nx = x + i, ny = y + j;
+                    if (nx < 0 || ny < 0 || nx >= b.cols || ny >= b.rows) continue;
+                    int index = ny * b.cols + nx;
+                    if (b.cells[index] & CELL_REVEALED) continue;
+                    auto it = s.idOf.find(index);
+                    if (it == s.idOf.end()) {
+                        it = s.idOf.emplace(index, (int)s.boardIndex.size()).first;
+                        s.boardIndex.push_back(index);
+                    }
+                    c.cells[c.count++] = it->second;
                 }
             }
-            grid[x][y].neighborCount = count;
+            if (c.count > 0) s.constraints.push_back(c);
+        }
+    }
+    int frontierCount = (int)s.boardIndex.size();
+    int constraintCount = (int)s.constraints.size();
+    s.state.assign(frontierCount, SOLVER_UNKNOWN);
+    s.cellConstraints.assign(frontierCount, std::vector<int>());
+    for (int c = 0; c < constraintCount; c++)
+        for (int k = 0; k < s.constraints[c].count; k++) s.cellConstraints[s.constraints[c].cells[k]].push_back(c);
+
+    // 规则 1、2 交替做到不动为止
+    s.queued.assign(constraintCount, 1);
+    s.queue.resize(constraintCount);
+    for (int c = 0; c < constraintCount; c++) s.queue[c] = c;
+    s.seenBy.assign(constraintCount, -1);
+    do {
+        PropagateSingles(s);
+    } while (PropagatePairs(s));
+
+    int knownMines = 0;
+    for (int id = 0; id < frontierCount; id++) {
+        if (s.state[id] == 0) out.safe.push_back(s.boardIndex[id]);
+        if (s.state[id] == 1) { out.mines.push_back(s.boardIndex[id]); knownMines++; }
+    }
+
+    // 剩下的边界格按共享约束分块
+    s.parent.resize(frontierCount);
+    for (int id = 0; id < frontierCount; id++) s.parent[id] = id;
+    int unknown[8], unknownCount;
+    for (int c = 0; c < constraintCount; c++) {
+        ReduceConstraint(s, s.constraints[c], unknown, unknownCount);
+        for (int k = 1; k < unknownCount; k++) s.parent[FindRoot(s.parent, unknown[k])] = FindRoot(s.parent, unknown[0]);
+    }
+    std::unordered_map<int, int> componentOf;
+    s.components.clear();
+    for (int id = 0; id < frontierCount; id++) {
+        if (s.state[id] != SOLVER_UNKNOWN) continue;
+        int root = FindRoot(s.parent, id);
+        auto it = componentOf.find(root);
+        if (it == componentOf.end()) {
+            it = componentOf.emplace(root, (int)s.components.size()).first;
+            s.components.emplace_back();
+        }
+        s.components[it->second].cells.push_back(id);
+    }
+    for (int c = 0; c < constraintCount; c++) {
+        ReduceConstraint(s, s.constraints[c], unknown, unknownCount);
+        if (unknownCount > 0) s.components[componentOf[FindRoot(s.parent, unknown[0])]].constraints.push_back(c);
+    }
+
+    // 各块互不相干，在线程池上并行穷举
+    // 只按引用捕获一个对象，std::function 放得进内部缓冲
+    struct { MineSolver* s; } job = { &s };
+    pool.Run((int)s.components.size(), [&job](int c) {
+        EnumerateComponent(*job.s, job.s->components[c]);
+    });
+
+    int interior = hidden - frontierCount;
+    int remaining = b.mines - knownMines;
+    int exactCells = 0;
+    bool allExact = true;
+    float approxMines = 0;
+    for (const SolverComponent& comp : s.components) {
+        out.components++;
+        if (comp.exact) { out.enumerated++; exactCells += (int)comp.cells.size(); }
+        else {
+            allExact = false;
+            for (float p : comp.estimate) approxMines += p;
+        }
+    }
+    out.interiorCount = interior;
+
+    // 内部格的摆法数作权重：weight(t) ∝ C(I, R - t)，t 是所有块的雷数之和
+    std::vector<double> weight(exactCells + 1, 0.0);
+    double maxLog = -1e300;
+    for (int t = 0; t <= exactCells; t++) {
+        int rest = remaining - t;
+        if (rest >= 0 && rest <= interior) maxLog = std::max(maxLog, LogChoose(interior, rest));
+    }
+    for (int t = 0; t <= exactCells; t++) {
+        int rest = remaining - t;
+        if (rest >= 0 && rest <= interior) weight[t] = exp(LogChoose(interior, rest) - maxLog);
+    }
+
+    // 精确加权：prefix/suffix 卷积得到"其余各块"的雷数分布
+    std::vector<std::vector<double>> others;
+    double total = 0;
+    std::vector<double> all;
+    out.globalExact = allExact && exactCells <= SOLVER_EXACT_FRONTIER;
+    if (out.globalExact) {
+        int m = (int)s.components.size();
+        auto convolve = [](const std::vector<double>& a, const std::vector<double>& b) {
+            std::vector<double> r(a.size() + b.size() - 1, 0.0);
+            for (size_t i = 0; i < a.size(); i++)
+                for (size_t j = 0; j < b.size(); j++) r[i + j] += a[i] * b[j];
+            return r;
+        };
+        // 先把每块的解数归一化，乘起来不会溢出
+        for (SolverComponent& comp : s.components) {
+            double sum = 0;
+            for (double w : comp.ways) sum += w;
+            for (double& w : comp.ways) w /= sum;
+            for (double& w : comp.mineWays) w /= sum;
+        }
+        std::vector<std::vector<double>> prefix(m + 1), suffix(m + 1);
+        prefix[0] = { 1.0 };
+        suffix[m] = { 1.0 };
+        for (int c = 0; c < m; c++) prefix[c + 1] = convolve(prefix[c], s.components[c].ways);
+        for (int c = m - 1; c >= 0; c--) suffix[c] = convolve(suffix[c + 1], s.components[c].ways);
+        all = prefix[m];
+        for (int t = 0; t < (int)all.size(); t++) total += all[t] * weight[t];
+        if (total > 0) {
+            others.resize(m);
+            for (int c = 0; c < m; c++) others[c] = convolve(prefix[c], suffix[c + 1]);
+        } else {
+            out.globalExact = false;    // 局面和总雷数对不上，退回近似
+        }
+    }
+
+    double interiorMines = 0;
+    for (int c = 0; c < (int)s.components.size(); c++) {
+        const SolverComponent& comp = s.components[c];
+        int n = (int)comp.cells.size();
+        std::vector<double> kWeight(n + 1, 0.0);
+        if (!comp.exact) {
+            for (int i = 0; i < n; i++) {
+                out.frontier.push_back(s.boardIndex[comp.cells[i]]);
+                out.probability.push_back(comp.estimate[i]);
+            }
+            continue;
+        }
+        if (out.globalExact) {
+            // 本块取 k 个雷时的总权重：Σ_j 其余块取 j 个的概率 × weight(k + j)
+            for (int k = 0; k <= n; k++)
+                for (int j = 0; j < (int)others[c].size() && k + j <= exactCells; j++) kWeight[k] += others[c][j] * weight[k + j] / total;
+        } else {
+            // 近似：其余部分按估计密度 d 看作独立，k 个雷的权重是 (d / (1 - d))^k
+            double density = interior + exactCells > 0 ? (remaining - approxMines) / (double)(interior + exactCells) : 0.5;
+            density = std::min(std::max(density, 0.001), 0.999);
+            double sum = 0;
+            for (int k = 0; k <= n; k++) sum += comp.ways[k] * pow(density / (1 - density), k);
+            for (int k = 0; k <= n; k++) kWeight[k] = sum > 0 ? pow(density / (1 - density), k) / sum : 0;
+        }
+        for (int i = 0; i < n; i++) {
+            double p = 0;
+            for (int k = 0; k <= n; k++) p += comp.mineWays[(size_t)k * n + i] * kWeight[k];
+            int index = s.boardIndex[comp.cells[i]];
+            if (p <= 1e-9) out.safe.push_back(index);
+            else if (p >= 1 - 1e-9) out.mines.push_back(index);
+            else {
+                out.frontier.push_back(index);
+                out.probability.push_back((float)p);
+            }
+            interiorMines += p;
+        }
+    }
+    if (interior > 0) {
+        if (out.globalExact) {
+            double expected = 0;
+            for (int t = 0; t < (int)all.size(); t++) expected += all[t] * weight[t] * (remaining - t);
+            out.interiorProbability = (float)(expected / total / interior);
+        } else {
+            out.interiorProbability = (float)std::min(std::max((remaining - approxMines - interiorMines) / interior, 0.0), 1.0);
         }
     }
 }
 
+// --- 提示与自动玩 ---
+bool showHints = false;
+int hintVersion = -1;                // 提示是按哪个 boardVersion 算的
+SolveResult hintResult;
+
+// 找一个不挨着数字的未知格，从 start 开始往后扫
+int FindInteriorCell(int start) {
+    int total = board.cols * board.rows;
+    for (int n = 0; n < total; n++) {
+        int index = (start + n) % total, x = index % board.cols, y = index / board.cols;
+        if (board.cells[index] & CELL_REVEALED) continue;
+        bool touches = false;
+        for (int j = -1; j <= 1 && !touches; j++)
+            for (int i = -1; i <= 1; i++)
+                if (IsValid(x + i, y + j) && (CellAt(x + i, y + j) & CELL_REVEALED)) { touches = true; break; }
+        if (!touches) return index;
+    }
+    return -1;
+}
+
+// 自动玩一步：翻开所有确定安全的格子、给确定的雷插旗；没有确定的就猜最不像雷的一格
+void AutoplayStep(WorkerPool& pool, SolveResult& result) {
+    if (isGameOver || isWin) return;
+    SolveBoard(board, pool, result);
+    for (int index : result.mines) board.cells[index] |= CELL_FLAGGED;
+    for (int index : result.safe) {
+        board.cells[index] &= ~CELL_FLAGGED;
+        OpenCell(index % board.cols, index / board.cols);
+    }
+    if (result.safe.empty()) {
+        int guess = -1;
+        float best = 2.0f;
+        for (size_t i = 0; i < result.frontier.size(); i++) {
+            if (result.probability[i] < best) { best = result.probability[i]; guess = result.frontier[i]; }
+        }
+        if (result.interiorCount > 0 && result.interiorProbability < best) {
+            int interior = FindInteriorCell((int)(NextMineRandom() % (uint64_t)(board.cols * board.rows)));
+            if (interior >= 0) guess = interior;
+        }
+        if (guess >= 0) {
+            board.cells[guess] &= ~CELL_FLAGGED;
+            OpenCell(guess % board.cols, guess / board.cols);
+        }
+    }
+    boardVersion++;
+}
+
+// --- 格子图集与批量绘制 ---
+// 所有格子样式（未翻开、0~8、旗、雷）启动时画进一张 256x256 的图集，每格一个 64 像素的图块，
+// 背景色和右下 2 像素的缝都烤在图块里。画一帧时只收集视野内的格子，每格推一个贴图四边形，
+// 攒满或画完才提交一次，整屏通常只有一个 draw call；每帧开销只和可见格子数有关
+#define ATLAS_TILE 64
+#define ATLAS_COLUMNS 4
+#define TILE_HIDDEN 9
+#define TILE_FLAG 10
+#define TILE_MINE 11            // 踩中或翻开的雷
+#define TILE_HIDDEN_MINE 12     // 结束后亮出来的未翻开的雷
+#define CELL_BATCH_QUADS 32768
+
+struct CellBatch {
+    unsigned int vao = 0, vboPosition = 0, vboTexcoord = 0, vboColor = 0;
+    float positions[CELL_BATCH_QUADS * 6 * 2];
+    float texcoords[CELL_BATCH_QUADS * 6 * 2];
+    unsigned char colors[CELL_BATCH_QUADS * 6 * 4];   // 全白，加载时填好不再更新
+    int quadCount = 0;
+    int drawCalls = 0;          // 本帧的 draw call 数
+    int frameQuads = 0;         // 本帧画的格子数
+};
+
+Texture2D cellAtlas = { 0 };
+CellBatch cellBatch;
+uint8_t cellTiles[2][256];      // [是否亮出雷][格子字节] -> 图块号，省掉逐格分支
+
+int TileForCell(uint8_t cell, bool showMine) {
+    if (cell & CELL_REVEALED) return (cell & CELL_MINE) ? TILE_MINE : (cell & CELL_COUNT_MASK);
+    if (cell & CELL_FLAGGED) return TILE_FLAG;
+    return (showMine && (cell & CELL_MINE)) ? TILE_HIDDEN_MINE : TILE_HIDDEN;
+}
+
+// 按原来 60 像素格子的图案等比画出各个图块
+void BakeCellAtlas() {
+    Image image = GenImageColor(ATLAS_TILE * ATLAS_COLUMNS, ATLAS_TILE * ATLAS_COLUMNS, BLANK);
+    const float s = (ATLAS_TILE - 2) / 58.0f;
+    const int body = ATLAS_TILE - 2;
+    for (int t = 0; t <= TILE_HIDDEN_MINE; t++) {
+        int x = (t % ATLAS_COLUMNS) * ATLAS_TILE, y = (t / ATLAS_COLUMNS) * ATLAS_TILE;
+        bool revealed = t <= 8 || t == TILE_MINE;
+        ImageDrawRectangle(&image, x, y, body, body, revealed ? Color{ 220, 225, 230, 255 } : Color{ 90, 100, 115, 255 });
+        if (t >= 1 && t <= 8) {
+            Color nColor = (t == 1) ? BLUE : (t == 2 ? DARKGREEN : RED);
+            ImageDrawText(&image, TextFormat("%d", t), x + (int)(22 * s), y + (int)(12 * s), (int)(36 * s), nColor);
+        } else if (t == TILE_MINE || t == TILE_HIDDEN_MINE) {
+            ImageDrawCircle(&image, x + body / 2, y + body / 2, (int)(12 * s), { 40, 40, 40, 255 });
+        } else if (t == TILE_FLAG) {
+            // 旗杆加一面三角旗，三角形逐行画横线
+            ImageDrawRectangle(&image, x + (int)(18 * s), y + (int)(12 * s), (int)(4 * s), (int)(35 * s), RED);
+            int top = (int)(12 * s), tip = (int)(20 * s), bottom = (int)(28 * s);
+            for (int row = top; row <= bottom; row++) {
+                float k = 1.0f - fabsf((float)(row - tip)) / (tip - top);
+                ImageDrawLine(&image, x + (int)(22 * s), y + row, x + (int)((22 + 23 * k) * s), y + row, RED);
+            }
+        }
+    }
+    cellAtlas = LoadTextureFromImage(image);
+    UnloadImage(image);
+    // 缩得很小时用 mipmap 取平均，不闪烁
+    GenTextureMipmaps(&cellAtlas);
+    SetTextureFilter(cellAtlas, TEXTURE_FILTER_TRILINEAR);
+}
+
+void LoadCellBatch(CellBatch& b) {
+    for (int t = 0; t < 2; t++)
+        for (int c = 0; c < 256; c++) cellTiles[t][c] = (uint8_t)TileForCell((uint8_t)c, t != 0);
+    memset(b.colors, 255, sizeof(b.colors));
+    int* locs = rlGetShaderLocsDefault();
+    b.vao = rlLoadVertexArray();
+    rlEnableVertexArray(b.vao);
+    b.vboPosition = rlLoadVertexBuffer(b.positions, sizeof(b.positions), true);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+    b.vboTexcoord = rlLoadVertexBuffer(b.texcoords, sizeof(b.texcoords), true);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+    b.vboColor = rlLoadVertexBuffer(b.colors, sizeof(b.colors), false);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, 0, 0);
+    rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+    rlDisableVertexArray();
+}
+
+void UnloadCellBatch(CellBatch& b) {
+    rlUnloadVertexArray(b.vao);
+    rlUnloadVertexBuffer(b.vboPosition);
+    rlUnloadVertexBuffer(b.vboTexcoord);
+    rlUnloadVertexBuffer(b.vboColor);
+}
+
+// 把攒下的四边形画出去。先刷掉 raylib 自己的批次，保证与其他图元的先后顺序
+void FlushCellBatch(CellBatch& b) {
+    if (b.quadCount == 0) return;
+    int vertices = b.quadCount * 6;
+    rlDrawRenderBatchActive();
+    rlUpdateVertexBuffer(b.vboPosition, b.positions, vertices * 2 * sizeof(float), 0);
+    rlUpdateVertexBuffer(b.vboTexcoord, b.texcoords, vertices * 2 * sizeof(float), 0);
+
+    int* locs = rlGetShaderLocsDefault();
+    rlEnableShader(rlGetShaderIdDefault());
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+    int slot = 0;
+    rlSetUniform(locs[RL_SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(cellAtlas.id);
+    if (!rlEnableVertexArray(b.vao)) {
+        rlEnableVertexBuffer(b.vboPosition);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+        rlEnableVertexBuffer(b.vboTexcoord);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+        rlEnableVertexBuffer(b.vboColor);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, 0, 0);
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+    }
+    rlDrawVertexArray(0, vertices);
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableTexture();
+    rlDisableShader();
+
+    b.drawCalls++;
+    b.frameQuads += b.quadCount;
+    b.quadCount = 0;
+}
+
+// 推一个格子：世界坐标 (x, y) 起、边长 size 的正方形，贴第 tile 个图块
+inline void PushCellQuad(CellBatch& b, float x, float y, float size, int tile) {
+    if (b.quadCount == CELL_BATCH_QUADS) FlushCellBatch(b);
+    // 图块四周各缩进半个纹素，避免采到相邻图块
+    const float texel = 1.0f / (ATLAS_TILE * ATLAS_COLUMNS);
+    float u0 = (tile % ATLAS_COLUMNS) * (1.0f / ATLAS_COLUMNS) + 0.5f * texel, u1 = u0 + (1.0f / ATLAS_COLUMNS) - texel;
+    float v0 = (tile / ATLAS_COLUMNS) * (1.0f / ATLAS_COLUMNS) + 0.5f * texel, v1 = v0 + (1.0f / ATLAS_COLUMNS) - texel;
+    const float px[6] = { x, x, x + size, x, x + size, x + size };
+    const float py[6] = { y, y + size, y + size, y, y + size, y };
+    const float pu[6] = { u0, u0, u1, u0, u1, u1 };
+    const float pv[6] = { v0, v1, v1, v0, v1, v0 };
+    float* pos = &b.positions[b.quadCount * 12];
+    float* tex = &b.texcoords[b.quadCount * 12];
+    for (int k = 0; k < 6; k++) {
+        pos[k * 2] = px[k];
+        pos[k * 2 + 1] = py[k];
+        tex[k * 2] = pu[k];
+        tex[k * 2 + 1] = pv[k];
+    }
+    b.quadCount++;
+}
+
+// 镜头看到的格子范围（含边上露出一部分的格子），cell 是世界坐标里的格子边长
+void VisibleCells(float cell, int& x0, int& y0, int& x1, int& y1) {
+    Vector2 topLeft = GetScreenToWorld2D({ 0, 0 }, camera);
+    Vector2 bottomRight = GetScreenToWorld2D({ (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT }, camera);
+    x0 = (int)floorf(topLeft.x / cell);
+    y0 = (int)floorf(topLeft.y / cell);
+    x1 = (int)floorf(bottomRight.x / cell);
+    y1 = (int)floorf(bottomRight.y / cell);
+}
+
+// 中键拖动或方向键平移，滚轮以鼠标为中心缩放
+void PanZoomCamera(float minZoom, float maxZoom) {
+    if (IsMouseButtonDown(MOUSE_MIDDLE_BUTTON)) {
+        Vector2 delta = GetMouseDelta();
+        camera.target = Vector2Subtract(camera.target, Vector2Scale(delta, 1.0f / camera.zoom));
+    }
+    float pan = 600.0f * GetFrameTime() / camera.zoom;
+    if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) camera.target.x -= pan;
+    if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) camera.target.x += pan;
+    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) camera.target.y -= pan;
+    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) camera.target.y += pan;
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0) {
+        // 缩放前后鼠标下的世界点保持不动
+        Vector2 mouse = GetMousePosition();
+        Vector2 before = GetScreenToWorld2D(mouse, camera);
+        camera.zoom = Clamp(camera.zoom * (wheel > 0 ? 1.25f : 0.8f), minZoom, maxZoom);
+        Vector2 after = GetScreenToWorld2D(mouse, camera);
+        camera.target = Vector2Add(camera.target, Vector2Subtract(before, after));
+    }
+}
+
+// --- 无限模式的一帧 ---
+void UpdateDrawInfinite() {
+    PanZoomCamera(MIN_SCREEN_CELL / INFINITE_CELL, MAX_ZOOM);
+
+    Vector2 mouseWorld = GetScreenToWorld2D(GetMousePosition(), camera);
+    int gx = (int)floorf(mouseWorld.x / INFINITE_CELL), gy = (int)floorf(mouseWorld.y / INFINITE_CELL);
+    if (!isGameOver) {
+        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) RevealInfinite(world, gx, gy);
+        if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+            uint8_t& cell = ModifyCell(world, gx, gy);
+            if (!(cell & CELL_REVEALED)) cell ^= CELL_FLAGGED;
+        }
+    } else if (IsKeyPressed(KEY_R) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        ResetInfinite(RandomSeed());
+    }
+
+    BeginDrawing();
+        ClearBackground({ 45, 50, 60, 255 });
+        cellBatch.drawCalls = 0;
+        cellBatch.frameQuads = 0;
+        BeginMode2D(camera);
+            // 只遍历视野覆盖的块，块内再裁到视野里的格子；看到的块按需生成
+            int x0, y0, x1, y1;
+            VisibleCells(INFINITE_CELL, x0, y0, x1, y1);
+            const uint8_t* tiles = cellTiles[isGameOver ? 1 : 0];
+            for (int cy = y0 >> CHUNK_SHIFT; cy <= y1 >> CHUNK_SHIFT; cy++) {
+                for (int cx = x0 >> CHUNK_SHIFT; cx <= x1 >> CHUNK_SHIFT; cx++) {
+                    const Chunk& chunk = GetChunk(world, cx, cy);
+                    int ly0 = std::max(y0 - cy * CHUNK_SIZE, 0), ly1 = std::min(y1 - cy * CHUNK_SIZE, CHUNK_SIZE - 1);
+                    int lx0 = std::max(x0 - cx * CHUNK_SIZE, 0), lx1 = std::min(x1 - cx * CHUNK_SIZE, CHUNK_SIZE - 1);
+                    for (int ly = ly0; ly <= ly1; ly++) {
+                        const uint8_t* row = &chunk.cells[ly * CHUNK_SIZE];
+                        for (int lx = lx0; lx <= lx1; lx++) {
+                            PushCellQuad(cellBatch, (cx * CHUNK_SIZE + lx) * INFINITE_CELL, (cy * CHUNK_SIZE + ly) * INFINITE_CELL,
+                                         INFINITE_CELL, tiles[row[lx]]);
+                        }
+                    }
+                }
+            }
+            FlushCellBatch(cellBatch);
+        EndMode2D();
+
+        DrawText(TextFormat("INFINITE  SEED %llu  REVEALED %d", (unsigned long long)world.seed, world.revealed), 10, 10, 18, RAYWHITE);
+        DrawText(TextFormat("CHUNKS %d (%d modified)  %d KB  generated %lld  evicted %lld", (int)world.chunks.size(), world.modifiedChunks,
+                            (int)(world.chunks.size() * sizeof(Chunk) / 1024), world.generated, world.evicted), 10, 32, 14, GRAY);
+        DrawText(TextFormat("CELLS %d  DRAW CALLS %d", cellBatch.frameQuads, cellBatch.drawCalls), 10, 50, 14, GRAY);
+        DrawText("MIDDLE DRAG / ARROWS: PAN   WHEEL: ZOOM   1/2/3: BOARD", 10, SCREEN_HEIGHT - 22, 16, GRAY);
+
+        if (isGameOver) {
+            DrawRectangle(0, SCREEN_HEIGHT/2 - 50, SCREEN_WIDTH, 100, Fade(BLACK, 0.75f));
+            const char* txt = TextFormat("BOOM! %d CELLS CLEARED", world.revealed);
+            DrawText(txt, SCREEN_WIDTH/2 - MeasureText(txt, 30)/2, SCREEN_HEIGHT/2 - 30, 30, RED);
+            DrawText("CLICK OR PRESS R FOR A NEW MAP", SCREEN_WIDTH/2 - MeasureText("CLICK OR PRESS R FOR A NEW MAP", 18)/2, SCREEN_HEIGHT/2 + 10, 18, GRAY);
+        }
+    EndDrawing();
+}
+
 void UpdateDrawFrame() {
+    for (int k = 0; k < 3; k++) {
+        if (IsKeyPressed(KEY_ONE + k)) SelectBoard(PRESETS[k]);
+    }
+    if (IsKeyPressed(KEY_I) && !infiniteMode) {
+        infiniteMode = true;
+        ResetInfinite(RandomSeed());
+    }
+    if (infiniteMode) {
+        UpdateDrawInfinite();
+        return;
+    }
+
+    // 缩小到一格至少 MIN_SCREEN_CELL 像素为止；镜头中心不离开棋盘
+    PanZoomCamera(std::min(MIN_SCREEN_CELL / cellSize, 1.0f), std::max(MAX_ZOOM, (float)MAX_CELL_SIZE / cellSize));
+    camera.target.x = Clamp(camera.target.x, 0.0f, (float)board.cols * cellSize);
+    camera.target.y = Clamp(camera.target.y, 0.0f, (float)board.rows * cellSize);
+
     if (!isGameOver && !isWin) {
+        Vector2 mouse = GetScreenToWorld2D(GetMousePosition(), camera);
+        int gx = (int)floorf(mouse.x / cellSize);
+        int gy = (int)floorf(mouse.y / cellSize);
         // 左键：挖开
         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 mouse = GetMousePosition();
-            int gx = (mouse.x - OFFSET_X) / CELL_SIZE;
-            int gy = (mouse.y - OFFSET_Y) / CELL_SIZE;
-            if (IsValid(gx, gy) && !grid[gx][gy].isFlagged) {
-                if (grid[gx][gy].isMine) {
-                    isGameOver = true;
-                    // 游戏结束，翻开所有地雷给玩家看
-                    for(int i=0; i<COLS; i++)
-                        for(int j=0; j<ROWS; j++)
-                            if(grid[i][j].isMine) grid[i][j].isRevealed = true;
-                } else {
-                    RevealCell(gx, gy);
-                }
-            }
+            OpenCell(gx, gy);
+            boardVersion++;
         }
         // 右键：插旗
         if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
-            Vector2 mouse = GetMousePosition();
-            int gx = (mouse.x - OFFSET_X) / CELL_SIZE;
-            int gy = (mouse.y - OFFSET_Y) / CELL_SIZE;
-            if (IsValid(gx, gy) && !grid[gx][gy].isRevealed) {
-                grid[gx][gy].isFlagged = !grid[gx][gy].isFlagged;
+            if (IsValid(gx, gy) && !(CellAt(gx, gy) & CELL_REVEALED)) {
+                CellAt(gx, gy) ^= CELL_FLAGGED;
             }
         }
+        // H：显示求解提示；空格：按求解结果自动走一步
+        if (IsKeyPressed(KEY_H)) showHints = !showHints;
+        if (IsKeyPressed(KEY_SPACE)) AutoplayStep(GetMinesPool(), hintResult);
     } else {
         // 结束状态下点击或按 R 重启
         if (IsKeyPressed(KEY_R) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) ResetGame();
     }
 
     BeginDrawing();
-        ClearBackground({ 45, 50, 60, 255 }); 
-
-        for (int x = 0; x < COLS; x++) {
-            for (int y = 0; y < ROWS; y++) {
-                Rectangle rect = {(float)OFFSET_X + x * CELL_SIZE, (float)OFFSET_Y + y * CELL_SIZE, (float)CELL_SIZE - 2, (float)CELL_SIZE - 2};
-                
-                if (grid[x][y].isRevealed) {
-                    DrawRectangleRec(rect, { 220, 225, 230, 255 });
-                    if (grid[x][y].isMine) {
-                        DrawCircleV({rect.x + CELL_SIZE/2, rect.y + CELL_SIZE/2}, 12, {40, 40, 40, 255});
-                    } else if (grid[x][y].neighborCount > 0) {
-                        Color nColor = (grid[x][y].neighborCount == 1) ? BLUE : (grid[x][y].neighborCount == 2 ? DARKGREEN : RED);
-                        DrawText(TextFormat("%d", grid[x][y].neighborCount), rect.x + 22, rect.y + 12, 36, nColor);
-                    }
-                } else {
-                    DrawRectangleRec(rect, { 90, 100, 115, 255 });
-                    if (grid[x][y].isFlagged) {
-                        // 画一个简单的小红旗
-                        DrawRectangle(rect.x + 18, rect.y + 12, 4, 35, RED);
-                        DrawTriangle({rect.x + 22, rect.y + 12}, {rect.x + 22, rect.y + 28}, {rect.x + 45, rect.y + 20}, RED);
-                    }
+        ClearBackground({ 45, 50, 60, 255 });
+
+        // 格子间留 2 像素缝，太小的格子就不留了；图案都按格子边长缩放
+        // 只画视野里的格子，逐行连续读取
+        cellBatch.drawCalls = 0;
+        cellBatch.frameQuads = 0;
+        BeginMode2D(camera);
+            int x0, y0, x1, y1;
+            VisibleCells((float)cellSize, x0, y0, x1, y1);
+            x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+            x1 = std::min(x1, board.cols - 1); y1 = std::min(y1, board.rows - 1);
+            const uint8_t* tiles = cellTiles[0];
+            for (int y = y0; y <= y1; y++) {
+                const uint8_t* row = &board.cells[(size_t)y * board.cols];
+                for (int x = x0; x <= x1; x++) PushCellQuad(cellBatch, (float)x * cellSize, (float)y * cellSize, (float)cellSize, tiles[row[x]]);
+            }
+            FlushCellBatch(cellBatch);
+
+            // 提示：绿 = 确定安全，红 = 确定是雷，其余边界格按是雷概率深浅着色
+            if (showHints && !isGameOver && !isWin) {
+                if (hintVersion != boardVersion) {
+                    SolveBoard(board, GetMinesPool(), hintResult);
+                    hintVersion = boardVersion;
                 }
+                auto shade = [&](int index, Color color) {
+                    int x = index % board.cols, y = index / board.cols;
+                    if (x < x0 || x > x1 || y < y0 || y > y1) return;
+                    DrawRectangleRec({ (float)x * cellSize, (float)y * cellSize, cellSize - 2.0f, cellSize - 2.0f }, color);
+                };
+                for (int index : hintResult.safe) shade(index, Fade(GREEN, 0.45f));
+                for (int index : hintResult.mines) shade(index, Fade(RED, 0.45f));
+                for (size_t i = 0; i < hintResult.frontier.size(); i++) shade(hintResult.frontier[i], Fade(ORANGE, 0.6f * hintResult.probability[i]));
             }
+        EndMode2D();
+
+        if (showHints && !isGameOver && !isWin) {
+            DrawText(TextFormat("SAFE %d  MINES %d  FRONTIER %d  INTERIOR %.1f%%  BLOCKS %d/%d%s", (int)hintResult.safe.size(), (int)hintResult.mines.size(),
+                                (int)hintResult.frontier.size(), hintResult.interiorProbability * 100.0f, hintResult.enumerated, hintResult.components,
+                                hintResult.globalExact ? "" : " (approx)"), 10, 10, 16, RAYWHITE);
         }
+        DrawText(TextFormat("%dx%d  %d MINES   CELLS %d  DRAW CALLS %d", board.cols, board.rows, board.mines,
+                            cellBatch.frameQuads, cellBatch.drawCalls), 10, SCREEN_HEIGHT - 42, 16, GRAY);
+        DrawText("1/2/3: SIZE   I: INFINITE   H: HINTS   SPACE: AUTO", 10, SCREEN_HEIGHT - 22, 16, GRAY);
 
         if (isGameOver || isWin) {
             DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.75f));
@@ -174,15 +1237,143 @@ void UpdateDrawFrame() {
     EndDrawing();
 }
 
-int main() {
+#if !defined(PLATFORM_WEB)
+// --- 邻雷计数基准（仅本地） ---
+// 按经典高级密度布雷，对比逐格 3x3 与位切片两种计数，并核对结果一致
+bool RunCountBenchmark() {
+    const int WIDTHS[] = { 1000, 4000, 10000 };
+    bool allMatch = true;
+    for (int width : WIDTHS) {
+        boardSize = { width, width, (int)((long long)width * width * 99 / 480) };
+        ResetGame();
+        std::vector<uint8_t> fast = board.cells;
+        auto t0 = std::chrono::steady_clock::now();
+        CountNeighborsScalar(board);
+        auto t1 = std::chrono::steady_clock::now();
+        CountNeighbors(board);
+        auto t2 = std::chrono::steady_clock::now();
+        std::vector<uint8_t> bitPlane = board.cells;
+        CountNeighborsScalar(board);
+        bool match = bitPlane == board.cells && fast == board.cells;
+        allMatch = allMatch && match;
+        double scalarMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double planeMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        printf("%5dx%-5d scalar %9.1f ms   bit-plane %7.1f ms   %5.1fx   %s\n",
+               width, width, scalarMs, planeMs, scalarMs / planeMs, match ? "match" : "MISMATCH");
+    }
+    return allMatch;
+}
+
+// --- 求解器基准（仅本地） ---
+// 开局翻开离中心最近的一块空地（相当于首击保护）
+void OpenStartCell() {
+    int best = -1;
+    long long bestDist = -1;
+    for (int y = 0; y < board.rows; y++) {
+        for (int x = 0; x < board.cols; x++) {
+            if (CellAt(x, y) & (CELL_MINE | CELL_COUNT_MASK)) continue;
+            long long dx = x - board.cols / 2, dy = y - board.rows / 2;
+            if (best < 0 || dx * dx + dy * dy < bestDist) { best = y * board.cols + x; bestDist = dx * dx + dy * dy; }
+        }
+    }
+    if (best >= 0) RevealCell(best % board.cols, best / board.cols);
+}
+
+// 经典高级 30x16：自动玩到底，统计每秒局数和胜率；
+// 大棋盘：自动玩几步得到一个中盘局面，反复求解它，统计每秒求解次数。两者都按线程数各跑一遍
+void RunSolveBenchmark(int maxThreads) {
+    if (maxThreads < 1) maxThreads = (int)std::thread::hardware_concurrency();
+    const double SECONDS = 2.0;
+    SolveResult result;
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        WorkerPool pool(threads);
+        boardSize = PRESETS[2];
+        int games = 0, wins = 0;
+        long long solves = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        while (elapsed < SECONDS) {
+            SetRandomSeed(games + 1);
+            ResetGame();
+            OpenStartCell();
+            while (!isGameOver && !isWin) {
+                AutoplayStep(pool, result);
+                solves++;
+            }
+            games++;
+            wins += isWin;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        printf("%d threads  30x16/99: %.0f games/s, %.1f%% won, %.0f solves/s\n",
+               pool.ThreadCount(), games / elapsed, 100.0 * wins / games, solves / elapsed);
+
+        const int SIDES[] = { 256, 1024 };
+        for (int side : SIDES) {
+            boardSize = { side, side, side * side * 99 / 480 };
+            SetRandomSeed(7);
+            ResetGame();
+            OpenStartCell();
+            // 只走确定的步，停在需要猜的中盘局面上
+            for (int step = 0; step < 64 && !isGameOver && !isWin; step++) {
+                SolveBoard(board, pool, result);
+                if (result.safe.empty()) break;
+                for (int index : result.safe) OpenCell(index % board.cols, index / board.cols);
+            }
+            int count = 0;
+            start = std::chrono::steady_clock::now();
+            elapsed = 0;
+            while (elapsed < SECONDS) {
+                SolveBoard(board, pool, result);
+                count++;
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            printf("%d threads  %dx%d: %.1f solves/s (%.2f ms), frontier %d, blocks %d/%d enumerated%s\n",
+                   pool.ThreadCount(), side, side, count / elapsed, elapsed * 1000.0 / count,
+                   (int)(result.frontier.size() + result.safe.size() + result.mines.size()), result.enumerated, result.components,
+                   result.globalExact ? "" : ", density-weighted");
+        }
+    }
+}
+#endif
+
+int main(int argc, char** argv) {
+#if !defined(PLATFORM_WEB)
+    if (argc > 1 && strcmp(argv[1], "--count-bench") == 0) return RunCountBenchmark() ? 0 : 1;
+    if (argc > 1 && strcmp(argv[1], "--solve-bench") == 0) {
+        RunSolveBenchmark(argc > 2 ? atoi(argv[2]) : 0);
+        return 0;
+    }
+    // 桌面端：--board 列数 行数 雷数，自定义棋盘尺寸
+    if (argc > 3 && strcmp(argv[1], "--board") == 0) {
+        BoardPreset custom = { atoi(argv[2]), atoi(argv[3]), argc > 4 ? atoi(argv[4]) : 0 };
+        if (custom.cols < 1) custom.cols = 1;
+        if (custom.rows < 1) custom.rows = 1;
+        if (custom.cols > MAX_BOARD_SIDE) custom.cols = MAX_BOARD_SIDE;
+        if (custom.rows > MAX_BOARD_SIDE) custom.rows = MAX_BOARD_SIDE;
+        // 不给雷数就按经典高级的密度（约 20.6%）
+        if (custom.mines <= 0) custom.mines = (int)((long long)custom.cols * custom.rows * 99 / 480);
+        boardSize = custom;
+    }
+#endif
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "TinyPulse - Minesweeper");
+    BakeCellAtlas();
+    LoadCellBatch(cellBatch);
     ResetGame();
+#if !defined(PLATFORM_WEB)
+    // 桌面端：--infinite [种子]，直接进无限模式，同一种子到哪台机器都是同一张图
+    if (argc > 1 && strcmp(argv[1], "--infinite") == 0) {
+        infiniteMode = true;
+        ResetInfinite(argc > 2 ? strtoull(argv[2], nullptr, 10) : RandomSeed());
+    }
+#endif
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
     SetTargetFPS(60);
     while (!WindowShouldClose()) UpdateDrawFrame();
 #endif
+    UnloadCellBatch(cellBatch);
+    UnloadTexture(cellAtlas);
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,17 @@
 #include "include/raylib.h"
+#include "include/raymath.h"
+#include "include/worker_pool.h"
 #include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -8,96 +20,643 @@
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
 const int GRID_SIZE = 20;
-const int GRID_WIDTH = SCREEN_WIDTH / GRID_SIZE;
+const int GRID_WIDTH = SCREEN_WIDTH / GRID_SIZE;   // 一屏可见的格数，也是经典模式的世界大小
 const int GRID_HEIGHT = SCREEN_HEIGHT / GRID_SIZE;
 
 struct SnakeNode {
     int x, y;
 };
 
-std::vector<SnakeNode> snake;
+// 直线段：蛇身上连续同向的一段格子，绘制时一段只画一个矩形
+struct SnakeRun {
+    SnakeNode head;   // 靠蛇头一端
+    SnakeNode tail;   // 靠蛇尾一端
+    int dx, dy;       // 行进方向，尾端沿此方向收缩
+};
+
+std::deque<SnakeNode> snake;
+std::deque<SnakeRun> snakeRuns; // front 为蛇头所在段
 Vector2 speed = { 1, 0 };
-Vector2 nextDir = { 1, 0 };
-SnakeNode food;
 int score = 0;
 bool isGameOver = false;
-float moveCounter = 0;
+float moveCounter = 0;      // 固定步长累加器，跨帧保留余量
 float moveDelay = 0.12f;
 
-void SpawnFood() {
-    food.x = GetRandomValue(0, GRID_WIDTH - 1);
-    food.y = GetRandomValue(0, GRID_HEIGHT - 1);
+// --- 转向队列：一个 tick 内连按的多次转向按顺序生效，每次入队时就校验合法性 ---
+const int TURN_QUEUE_SIZE = 3;
+const int MAX_STEPS_PER_FRAME = 8; // 卡顿太久时丢弃积压，避免一帧内连走太多步
+Vector2 turnQueue[TURN_QUEUE_SIZE];
+int turnCount = 0;
+
+// --- 渲染插值：蛇头从上一格滑向当前格，蛇尾从刚离开的格子滑走 ---
+bool interpolateMotion = true;
+SnakeNode lastTail;
+bool tailMoved = false;
+
+// --- 稀疏分块世界：世界大小与窗口脱钩，只有含蛇身或食物的 32x32 块才分配内存 ---
+const int CHUNK_SIZE = 32;
+const int BIG_WORLD_SIZE = 100000;
+const int BIG_WORLD_FOOD = 16;   // 大世界里当前一屏内始终保持的食物数
+const int FOOD_KEEP_MARGIN = GRID_WIDTH / 2;   // 落在一屏外这么多格以外的食物回收掉，连同它占着的块一起释放
+const uint8_t CELL_EMPTY = 0;
+const uint8_t CELL_SNAKE = 1;
+const uint8_t CELL_FOOD = 2;
+
+struct Chunk {
+    uint8_t cells[CHUNK_SIZE * CHUNK_SIZE] = { 0 };
+    int used = 0;   // 非空格子数，归零即释放整块
+};
+
+bool bigWorld = false;
+int worldWidth = GRID_WIDTH;
+int worldHeight = GRID_HEIGHT;
+std::vector<SnakeNode> foods;   // 所有食物的位置，回收和计数都只扫这张小表
+std::unordered_map<int64_t, std::unique_ptr<Chunk>> chunks;
+Camera2D camera = { 0 };
+
+// --- 竞技场模式：成千上万条 AI 蛇共享一张大网格 ---
+// 每个 tick 分三步：
+//   1. 思考：按蛇头所在行条带并行，只读网格，各蛇用自己的随机数决定方向
+//   2. 结算：按目标格所在行条带并行，同一格的多个蛇头按 (更长, 编号更小) 决出唯一胜者，
+//      其余撞墙/撞身/对撞失败的蛇身体全部变成食物。每格只归一个条带管，结果与线程数无关
+//   3. 收尾：单线程按编号顺序复活死蛇、补充食物
+const int ARENA_EMPTY = -1;
+const int ARENA_FOOD = -2;
+const int ARENA_STRIPES = 64;
+const int DIR_X[4] = { 1, 0, -1, 0 };
+const int DIR_Y[4] = { 0, 1, 0, -1 };
+
+struct ArenaSnake {
+    std::deque<int> body;   // 格子下标 y * width + x，front 为蛇头
+    int dir = 0;            // 0 右 1 下 2 左 3 上
+    int target = -1;        // 本 tick 想进入的格子，-1 表示撞墙
+    bool alive = false;
+    bool blocked = false;
+    bool died = false;      // 本 tick 刚被淘汰；复活没找到空位时 alive 仍为 false，但不再重复计死亡
+    int foodDelta = 0;      // 本 tick 对食物总数的贡献
+    uint64_t rng = 0;
+};
+
+struct Arena {
+    int width = 0;
+    int height = 0;
+    int stripeRows = 1;
+    std::vector<int> cells;
+    std::vector<ArenaSnake> snakes;
+    std::vector<std::vector<int>> thinkBuckets;
+    std::vector<std::vector<int>> resolveBuckets;
+    int foodTarget = 0;
+    int foodCount = 0;
+    int deathsLastTick = 0;
+    long long ticks = 0;
+    uint64_t rng = 0;
+};
+
+uint64_t NextRandom(uint64_t& state) {
+    // splitmix64：每条蛇各持一份状态，多线程下也可复现
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+bool ArenaPlaceSnake(Arena& a, int id) {
+    ArenaSnake& s = a.snakes[id];
+    for (int tries = 0; tries < 8; tries++) {
+        int c = (int)(NextRandom(a.rng) % (uint64_t)a.cells.size());
+        if (a.cells[c] != ARENA_EMPTY) continue;
+        s.body.clear();
+        s.body.push_back(c);
+        s.dir = (int)(NextRandom(a.rng) & 3);
+        s.alive = true;
+        a.cells[c] = id;
+        return true;
+    }
+    return false;
+}
+
+void ArenaSpawnFood(Arena& a) {
+    int attempts = (a.foodTarget - a.foodCount) * 4;
+    while (a.foodCount < a.foodTarget && attempts-- > 0) {
+        int c = (int)(NextRandom(a.rng) % (uint64_t)a.cells.size());
+        if (a.cells[c] != ARENA_EMPTY) continue;
+        a.cells[c] = ARENA_FOOD;
+        a.foodCount++;
+    }
+}
+
+void ArenaInit(Arena& a, int width, int height, int snakeCount, uint64_t seed) {
+    a.width = width;
+    a.height = height;
+    a.stripeRows = (height + ARENA_STRIPES - 1) / ARENA_STRIPES;
+    a.cells.assign((size_t)width * height, ARENA_EMPTY);
+    a.snakes.assign(snakeCount, ArenaSnake());
+    a.thinkBuckets.assign(ARENA_STRIPES, std::vector<int>());
+    a.resolveBuckets.assign(ARENA_STRIPES, std::vector<int>());
+    a.foodTarget = width * height / 64;
+    a.foodCount = 0;
+    a.ticks = 0;
+    a.rng = seed;
+    for (int i = 0; i < snakeCount; i++) {
+        a.snakes[i].rng = seed ^ ((uint64_t)(i + 1) * 0xD1B54A32D192ED03ULL);
+        ArenaPlaceSnake(a, i);
+    }
+    ArenaSpawnFood(a);
+}
+
+int ArenaFreeNeighbors(const Arena& a, int x, int y) {
+    int n = 0;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+        if (nx >= 0 && nx < a.width && ny >= 0 && ny < a.height && a.cells[ny * a.width + nx] < 0) n++;
+    }
+    return n;
+}
+
+// 只读网格，只写自己：直行/左转/右转三选一，优先食物和开阔处
+void ArenaThink(const Arena& a, ArenaSnake& s) {
+    int head = s.body.front();
+    int hx = head % a.width, hy = head / a.width;
+    int bestScore = -1;
+    s.target = -1;
+    s.blocked = true;
+    const int turns[3] = { 0, 1, 3 };
+    for (int t : turns) {
+        int d = (s.dir + t) & 3;
+        int nx = hx + DIR_X[d], ny = hy + DIR_Y[d];
+        if (nx < 0 || nx >= a.width || ny < 0 || ny >= a.height) continue;
+        int c = ny * a.width + nx;
+        if (a.cells[c] >= 0) continue;
+        int score = ArenaFreeNeighbors(a, nx, ny) * 2 + (int)(NextRandom(s.rng) & 3) + (t == 0 ? 1 : 0);
+        if (a.cells[c] == ARENA_FOOD) score += 8;
+        if (score > bestScore) {
+            bestScore = score;
+            s.dir = d;
+            s.target = c;
+            s.blocked = false;
+        }
+    }
+}
+
+void ArenaKill(Arena& a, ArenaSnake& s) {
+    // 淘汰的蛇整条变成食物；这些格子只属于它自己，可以在任何条带里安全改写
+    for (int c : s.body) a.cells[c] = ARENA_FOOD;
+    s.foodDelta += (int)s.body.size();
+    s.body.clear();
+    s.alive = false;
+    s.died = true;
+}
+
+void ArenaResolveStripe(Arena& a, std::vector<int>& bucket) {
+    // 同一目标格的蛇排在一起，长者优先、编号小者优先
+    std::sort(bucket.begin(), bucket.end(), [&a](int l, int r) {
+        const ArenaSnake& sl = a.snakes[l];
+        const ArenaSnake& sr = a.snakes[r];
+        if (sl.target != sr.target) return sl.target < sr.target;
+        if (sl.body.size() != sr.body.size()) return sl.body.size() > sr.body.size();
+        return l < r;
+    });
+    int lastWinnerTarget = -1;
+    for (int id : bucket) {
+        ArenaSnake& s = a.snakes[id];
+        if (s.blocked || s.target == lastWinnerTarget) {
+            ArenaKill(a, s);
+            continue;
+        }
+        lastWinnerTarget = s.target;
+        if (a.cells[s.target] == ARENA_FOOD) {
+            s.foodDelta -= 1;
+        } else {
+            a.cells[s.body.back()] = ARENA_EMPTY;
+            s.body.pop_back();
+        }
+        s.body.push_front(s.target);
+        a.cells[s.target] = id;
+    }
+}
+
+void ArenaTick(Arena& a, WorkerPool& pool) {
+    for (auto& b : a.thinkBuckets) b.clear();
+    for (auto& b : a.resolveBuckets) b.clear();
+    for (int i = 0; i < (int)a.snakes.size(); i++) {
+        if (a.snakes[i].alive) a.thinkBuckets[a.snakes[i].body.front() / a.width / a.stripeRows].push_back(i);
+    }
+
+    pool.Run(ARENA_STRIPES, [&a](int stripe) {
+        for (int id : a.thinkBuckets[stripe]) ArenaThink(a, a.snakes[id]);
+    });
+
+    for (int stripe = 0; stripe < ARENA_STRIPES; stripe++) {
+        for (int id : a.thinkBuckets[stripe]) {
+            const ArenaSnake& s = a.snakes[id];
+            int cell = s.blocked ? s.body.front() : s.target;
+            a.resolveBuckets[cell / a.width / a.stripeRows].push_back(id);
+        }
+    }
+
+    pool.Run(ARENA_STRIPES, [&a](int stripe) { ArenaResolveStripe(a, a.resolveBuckets[stripe]); });
+
+    a.deathsLastTick = 0;
+    for (int i = 0; i < (int)a.snakes.size(); i++) {
+        ArenaSnake& s = a.snakes[i];
+        a.foodCount += s.foodDelta;
+        s.foodDelta = 0;
+        if (s.died) {
+            a.deathsLastTick++;
+            s.died = false;
+        }
+        if (!s.alive) ArenaPlaceSnake(a, i);
+    }
+    ArenaSpawnFood(a);
+    a.ticks++;
+}
+
+uint64_t ArenaChecksum(const Arena& a) {
+    uint64_t h = 1469598103934665603ULL;
+    for (int c : a.cells) h = (h ^ (uint64_t)(uint32_t)c) * 1099511628211ULL;
+    return h;
+}
+
+// 扩展性基准：不同蛇数 x 不同线程数下的 tick/s，校验和相同说明结果与线程数无关
+// 用法：snake_game --arena-bench [最大线程数]，默认取全部核心
+void RunArenaBenchmark(int maxThreads) {
+    const int ARENA_BENCH_SIZE = 2048;
+    const int snakeCounts[] = { 1000, 4000, 16000 };
+    if (maxThreads < 1) maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    printf("arena %dx%d\n", ARENA_BENCH_SIZE, ARENA_BENCH_SIZE);
+    printf("%8s %8s %12s %18s\n", "snakes", "threads", "ticks/s", "checksum");
+    for (int snakeCount : snakeCounts) {
+        for (int threads : threadCounts) {
+            Arena a;
+            ArenaInit(a, ARENA_BENCH_SIZE, ARENA_BENCH_SIZE, snakeCount, 20240601);
+            WorkerPool pool(threads);
+            for (int i = 0; i < 20; i++) ArenaTick(a, pool);
+            const int ticks = 200;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < ticks; i++) ArenaTick(a, pool);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("%8d %8d %12.1f %18llx\n", snakeCount, threads, ticks / seconds, (unsigned long long)ArenaChecksum(a));
+        }
+    }
+}
+
+// --- 竞技场观战：TAB 切换，400x300 的小竞技场每格 2 像素，整张图作为一张纹理上传 ---
+const int ARENA_VIEW_WIDTH = SCREEN_WIDTH / 2;
+const int ARENA_VIEW_HEIGHT = SCREEN_HEIGHT / 2;
+const int ARENA_VIEW_SNAKES = 800;
+
+bool arenaMode = false;
+Arena viewArena;
+Texture2D arenaTexture = { 0 };
+std::vector<Color> arenaPixels;
+
+WorkerPool& GetArenaPool() {
+    static WorkerPool pool((int)std::thread::hardware_concurrency());
+    return pool;
+}
+
+void ToggleArena() {
+    arenaMode = !arenaMode;
+    if (arenaMode && arenaTexture.id == 0) {
+        ArenaInit(viewArena, ARENA_VIEW_WIDTH, ARENA_VIEW_HEIGHT, ARENA_VIEW_SNAKES, (uint64_t)GetRandomValue(1, 1 << 30));
+        arenaPixels.assign((size_t)ARENA_VIEW_WIDTH * ARENA_VIEW_HEIGHT, BLACK);
+        Image img = GenImageColor(ARENA_VIEW_WIDTH, ARENA_VIEW_HEIGHT, BLACK);
+        arenaTexture = LoadTextureFromImage(img);
+        UnloadImage(img);
+    }
+}
+
+void UpdateDrawArena() {
+    ArenaTick(viewArena, GetArenaPool());
+
+    for (size_t i = 0; i < viewArena.cells.size(); i++) {
+        int c = viewArena.cells[i];
+        if (c == ARENA_EMPTY) arenaPixels[i] = { 15, 15, 15, 255 };
+        else if (c == ARENA_FOOD) arenaPixels[i] = RED;
+        else arenaPixels[i] = ColorFromHSV((float)((c * 37) % 360), 0.7f, 0.95f);
+    }
+    UpdateTexture(arenaTexture, arenaPixels.data());
+
+    int alive = 0;
+    for (const auto& s : viewArena.snakes) if (s.alive) alive++;
+
+    BeginDrawing();
+        ClearBackground({ 15, 15, 15, 255 });
+        DrawTextureEx(arenaTexture, { 0, 0 }, 0, 2.0f, WHITE);
+        DrawText(TextFormat("ARENA  snakes: %d  food: %d  deaths: %d", alive, viewArena.foodCount, viewArena.deathsLastTick), 20, 20, 20, RAYWHITE);
+        DrawText("TAB to return", 20, 45, 15, GRAY);
+    EndDrawing();
+}
+
+// --- 分块读写：读不存在的块视为空地，写空地时不分配 ---
+int64_t ChunkKey(int cx, int cy) {
+    return ((int64_t)cy << 32) | (uint32_t)cx;
+}
+
+uint8_t GetCell(int x, int y) {
+    auto it = chunks.find(ChunkKey(x / CHUNK_SIZE, y / CHUNK_SIZE));
+    if (it == chunks.end()) return CELL_EMPTY;
+    return it->second->cells[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+}
+
+void SetCell(int x, int y, uint8_t value) {
+    int64_t key = ChunkKey(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    auto it = chunks.find(key);
+    if (it == chunks.end()) {
+        if (value == CELL_EMPTY) return;
+        it = chunks.emplace(key, std::unique_ptr<Chunk>(new Chunk())).first;
+    }
+    Chunk& chunk = *it->second;
+    uint8_t& cell = chunk.cells[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+    if (cell == CELL_EMPTY && value != CELL_EMPTY) chunk.used++;
+    if (cell != CELL_EMPTY && value == CELL_EMPTY) chunk.used--;
+    cell = value;
+    if (chunk.used == 0) chunks.erase(it);
+}
+
+// 以蛇头为中心、夹在世界范围内的一屏格子；经典模式下恰好是整个世界
+void GetViewCells(int& x0, int& y0) {
+    x0 = snake[0].x - GRID_WIDTH / 2;
+    y0 = snake[0].y - GRID_HEIGHT / 2;
+    if (x0 > worldWidth - GRID_WIDTH) x0 = worldWidth - GRID_WIDTH;
+    if (y0 > worldHeight - GRID_HEIGHT) y0 = worldHeight - GRID_HEIGHT;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+}
+
+// --- 直线段增量维护：每步只动头尾两段，O(1) ---
+void PushHeadRun(SnakeNode head, int dx, int dy) {
+    if (!snakeRuns.empty() && snakeRuns.front().dx == dx && snakeRuns.front().dy == dy) {
+        snakeRuns.front().head = head;
+    } else {
+        snakeRuns.push_front({ head, head, dx, dy });
+    }
+}
+
+void PopTailRun() {
+    SnakeRun& run = snakeRuns.back();
+    if (run.tail.x == run.head.x && run.tail.y == run.head.y) {
+        snakeRuns.pop_back();
+    } else {
+        run.tail.x += run.dx;
+        run.tail.y += run.dy;
+    }
+}
+
+void DrawCellLerp(SnakeNode from, SnakeNode to, float alpha, Color c) {
+    float x = from.x + (to.x - from.x) * alpha;
+    float y = from.y + (to.y - from.y) * alpha;
+    DrawRectangleRec({ x * GRID_SIZE + 1, y * GRID_SIZE + 1, (float)GRID_SIZE - 2, (float)GRID_SIZE - 2 }, c);
+}
+
+// alpha 为当前 tick 的进度 [0, 1]，1 即不插值；(x0, y0)-(x1, y1) 为可见格范围，范围外的段不画
+void DrawSnakeRuns(float alpha, int x0, int y0, int x1, int y1) {
+    // 刚离开的尾格滑入现在的尾格
+    if (tailMoved) DrawCellLerp(lastTail, snake.back(), alpha, GREEN);
+
+    for (size_t i = 0; i < snakeRuns.size(); i++) {
+        SnakeRun run = snakeRuns[i];
+        if (i == 0) {
+            // 蛇头格单独画，头段只画到脖子
+            if (run.head.x == run.tail.x && run.head.y == run.tail.y) continue;
+            run.head.x -= run.dx;
+            run.head.y -= run.dy;
+        }
+        int minX = run.head.x < run.tail.x ? run.head.x : run.tail.x;
+        int minY = run.head.y < run.tail.y ? run.head.y : run.tail.y;
+        int w = abs(run.head.x - run.tail.x) + 1;
+        int h = abs(run.head.y - run.tail.y) + 1;
+        if (minX > x1 || minY > y1 || minX + w <= x0 || minY + h <= y0) continue;
+        DrawRectangle(minX * GRID_SIZE + 1, minY * GRID_SIZE + 1, w * GRID_SIZE - 2, h * GRID_SIZE - 2, GREEN);
+    }
+    // 蛇头颜色区分
+    DrawCellLerp(snake[1], snake[0], alpha, LIME);
+}
+
+void PlaceFood(int x, int y) {
+    SetCell(x, y, CELL_FOOD);
+    foods.push_back({ x, y });
+}
+
+// 食物只投放在以 (x0, y0) 起的一屏内，保证大世界里也够得着。
+// 随机试 32 次都撞上蛇身时，从随机起点把这一屏线性扫一遍；这一屏确实满了才返回 false
+bool SpawnFood(int x0, int y0) {
+    for (int tries = 0; tries < 32; tries++) {
+        int x = x0 + GetRandomValue(0, GRID_WIDTH - 1);
+        int y = y0 + GetRandomValue(0, GRID_HEIGHT - 1);
+        if (GetCell(x, y) != CELL_EMPTY) continue;
+        PlaceFood(x, y);
+        return true;
+    }
+    const int cells = GRID_WIDTH * GRID_HEIGHT;
+    int start = GetRandomValue(0, cells - 1);
+    for (int n = 0; n < cells; n++) {
+        int i = (start + n) % cells;
+        int x = x0 + i % GRID_WIDTH, y = y0 + i / GRID_WIDTH;
+        if (GetCell(x, y) != CELL_EMPTY) continue;
+        PlaceFood(x, y);
+        return true;
+    }
+    return false;
+}
+
+void EatFood(SnakeNode at) {
+    for (size_t i = 0; i < foods.size(); i++) {
+        if (foods[i].x != at.x || foods[i].y != at.y) continue;
+        foods[i] = foods.back();
+        foods.pop_back();
+        return;
+    }
+}
+
+int FoodTarget() {
+    return bigWorld ? BIG_WORLD_FOOD : 1;
+}
+
+// 只有当前一屏内的食物计入目标数：被甩在身后的食物不再占名额，
+// 离开一屏外 FOOD_KEEP_MARGIN 格的直接回收，地图上的食物总数和它们占的块都有上限。
+// 一屏都被蛇占满时先不补，之后每步再试；返回补完后屏内的食物数
+int RefillFood() {
+    int x0, y0;
+    GetViewCells(x0, y0);
+    int inView = 0;
+    for (size_t i = 0; i < foods.size(); ) {
+        SnakeNode f = foods[i];
+        if (f.x < x0 - FOOD_KEEP_MARGIN || f.x >= x0 + GRID_WIDTH + FOOD_KEEP_MARGIN ||
+            f.y < y0 - FOOD_KEEP_MARGIN || f.y >= y0 + GRID_HEIGHT + FOOD_KEEP_MARGIN) {
+            SetCell(f.x, f.y, CELL_EMPTY);
+            foods[i] = foods.back();
+            foods.pop_back();
+            continue;
+        }
+        if (f.x >= x0 && f.x < x0 + GRID_WIDTH && f.y >= y0 && f.y < y0 + GRID_HEIGHT) inView++;
+        i++;
+    }
+    while (inView < FoodTarget() && SpawnFood(x0, y0)) inView++;
+    return inView;
 }
 
 void ResetGame() {
+    worldWidth = bigWorld ? BIG_WORLD_SIZE : GRID_WIDTH;
+    worldHeight = bigWorld ? BIG_WORLD_SIZE : GRID_HEIGHT;
+    int startX = bigWorld ? worldWidth / 2 : 10;
+    int startY = bigWorld ? worldHeight / 2 : 10;
+
+    chunks.clear();
+    foods.clear();
     snake.clear();
-    snake.push_back({ 10, 10 });
-    snake.push_back({ 9, 10 });
-    snake.push_back({ 8, 10 });
+    for (int i = 0; i < 3; i++) {
+        snake.push_back({ startX - i, startY });
+        SetCell(startX - i, startY, CELL_SNAKE);
+    }
+    snakeRuns.clear();
+    snakeRuns.push_back({ snake.front(), snake.back(), 1, 0 });
+    lastTail = snake.back();
+    tailMoved = false;
     speed = { 1, 0 };
-    nextDir = { 1, 0 };
+    turnCount = 0;
+    moveCounter = 0;
     score = 0;
     isGameOver = false;
     moveDelay = 0.12f;
-    SpawnFood();
+    RefillFood();
 }
 
-void UpdateDrawFrame() {
-    if (!isGameOver) {
-        if ((IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) && speed.y == 0) nextDir = { 0, -1 };
-        if ((IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) && speed.y == 0) nextDir = { 0, 1 };
-        if ((IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) && speed.x == 0) nextDir = { -1, 0 };
-        if ((IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) && speed.x == 0) nextDir = { 1, 0 };
+void QueueTurn(float dx, float dy) {
+    if (turnCount >= TURN_QUEUE_SIZE) return;
+    // 只接受与前一个方向垂直的转向，掉头和重复按键直接丢弃
+    Vector2 last = (turnCount > 0) ? turnQueue[turnCount - 1] : speed;
+    if ((dx != 0 && last.x != 0) || (dy != 0 && last.y != 0)) return;
+    turnQueue[turnCount++] = { dx, dy };
+}
 
-        moveCounter += GetFrameTime();
-        if (moveCounter >= moveDelay) {
-            moveCounter = 0;
-            speed = nextDir;
+void StepSnake() {
+    if (turnCount > 0) {
+        speed = turnQueue[0];
+        for (int i = 1; i < turnCount; i++) turnQueue[i - 1] = turnQueue[i];
+        turnCount--;
+    }
 
-            SnakeNode nextHead = { snake[0].x + (int)speed.x, snake[0].y + (int)speed.y };
+    SnakeNode nextHead = { snake[0].x + (int)speed.x, snake[0].y + (int)speed.y };
 
-            if (nextHead.x < 0 || nextHead.x >= GRID_WIDTH || nextHead.y < 0 || nextHead.y >= GRID_HEIGHT) {
-                isGameOver = true;
-            }
+    if (nextHead.x < 0 || nextHead.x >= worldWidth || nextHead.y < 0 || nextHead.y >= worldHeight) {
+        isGameOver = true;
+        return;
+    }
 
-            for (const auto& node : snake) {
-                if (nextHead.x == node.x && nextHead.y == node.y) {
-                    isGameOver = true;
-                    break;
-                }
-            }
+    // 自撞检测直接查占用格，O(1)
+    uint8_t target = GetCell(nextHead.x, nextHead.y);
+    if (target == CELL_SNAKE) {
+        isGameOver = true;
+        return;
+    }
 
-            if (!isGameOver) {
-                snake.insert(snake.begin(), nextHead);
-                if (nextHead.x == food.x && nextHead.y == food.y) {
-                    score += 10;
-                    moveDelay *= 0.98f;
-                    SpawnFood();
-                    #if defined(PLATFORM_WEB)
-                    EM_ASM({ if (window.parent && window.parent.UpdateWebScore) window.parent.UpdateWebScore($0); }, score);
-                    #endif
-                } else {
-                    snake.pop_back();
-                }
+    snake.push_front(nextHead);
+    SetCell(nextHead.x, nextHead.y, CELL_SNAKE);
+    PushHeadRun(nextHead, (int)speed.x, (int)speed.y);
+    lastTail = snake.back();
+    if (target == CELL_FOOD) {
+        tailMoved = false;
+        score += 10;
+        moveDelay *= 0.98f;
+        EatFood(nextHead);
+        #if defined(PLATFORM_WEB)
+        EM_ASM({ if (window.parent && window.parent.UpdateWebScore) window.parent.UpdateWebScore($0); }, score);
+        #endif
+    } else {
+        tailMoved = true;
+        SetCell(lastTail.x, lastTail.y, CELL_EMPTY);
+        snake.pop_back();
+        PopTailRun();
+    }
+    // 每步都补一次：吃掉的和屏外回收的补上，之前一屏满了没投成的这里接着补
+    RefillFood();
+}
+
+void UpdateDrawFrame() {
+    if (IsKeyPressed(KEY_TAB)) ToggleArena();
+    if (arenaMode) {
+        UpdateDrawArena();
+        return;
+    }
+
+    if (!isGameOver) {
+        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) QueueTurn(0, -1);
+        if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) QueueTurn(0, 1);
+        if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) QueueTurn(-1, 0);
+        if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) QueueTurn(1, 0);
+        if (IsKeyPressed(KEY_I)) interpolateMotion = !interpolateMotion;
+        if (IsKeyPressed(KEY_M)) {
+            bigWorld = !bigWorld;
+            ResetGame();
+        }
+
+        // 固定步长：减去 moveDelay 而不是清零，余量留给下一帧
+        moveCounter += GetFrameTime();
+        int steps = 0;
+        while (moveCounter >= moveDelay && !isGameOver) {
+            moveCounter -= moveDelay;
+            StepSnake();
+            if (++steps >= MAX_STEPS_PER_FRAME) {
+                moveCounter = 0;
+                break;
             }
         }
     } else {
         if (IsKeyPressed(KEY_R) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) ResetGame();
     }
 
+    float alpha = (interpolateMotion && !isGameOver) ? moveCounter / moveDelay : 1.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+
+    // 镜头跟随插值后的蛇头，并夹在世界边界内；经典模式下世界等于一屏，镜头不动
+    float worldPxW = (float)worldWidth * GRID_SIZE, worldPxH = (float)worldHeight * GRID_SIZE;
+    camera.offset = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f };
+    camera.target = { (snake[1].x + (snake[0].x - snake[1].x) * alpha + 0.5f) * GRID_SIZE,
+                      (snake[1].y + (snake[0].y - snake[1].y) * alpha + 0.5f) * GRID_SIZE };
+    camera.target.x = Clamp(camera.target.x, SCREEN_WIDTH / 2.0f, worldPxW - SCREEN_WIDTH / 2.0f);
+    camera.target.y = Clamp(camera.target.y, SCREEN_HEIGHT / 2.0f, worldPxH - SCREEN_HEIGHT / 2.0f);
+    camera.zoom = 1.0f;
+    int x0 = (int)((camera.target.x - camera.offset.x) / GRID_SIZE);
+    int y0 = (int)((camera.target.y - camera.offset.y) / GRID_SIZE);
+    int x1 = x0 + GRID_WIDTH;
+    int y1 = y0 + GRID_HEIGHT;
+
     BeginDrawing();
         ClearBackground({ 15, 15, 15, 255 });
 
-        // 画食物
-        DrawRectangle(food.x * GRID_SIZE + 2, food.y * GRID_SIZE + 2, GRID_SIZE - 4, GRID_SIZE - 4, RED);
+        BeginMode2D(camera);
+            // 只遍历可见的块：大世界里画出块边框作为参照，再画块内的食物
+            for (int cy = y0 / CHUNK_SIZE; cy <= y1 / CHUNK_SIZE; cy++) {
+                for (int cx = x0 / CHUNK_SIZE; cx <= x1 / CHUNK_SIZE; cx++) {
+                    if (bigWorld) DrawRectangleLines(cx * CHUNK_SIZE * GRID_SIZE, cy * CHUNK_SIZE * GRID_SIZE, CHUNK_SIZE * GRID_SIZE, CHUNK_SIZE * GRID_SIZE, { 30, 30, 30, 255 });
+                    auto it = chunks.find(ChunkKey(cx, cy));
+                    if (it == chunks.end()) continue;
+                    const Chunk& chunk = *it->second;
+                    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+                        if (chunk.cells[i] != CELL_FOOD) continue;
+                        int fx = cx * CHUNK_SIZE + i % CHUNK_SIZE;
+                        int fy = cy * CHUNK_SIZE + i / CHUNK_SIZE;
+                        DrawRectangle(fx * GRID_SIZE + 2, fy * GRID_SIZE + 2, GRID_SIZE - 4, GRID_SIZE - 4, RED);
+                    }
+                }
+            }
+            if (bigWorld) DrawRectangleLines(0, 0, (int)worldPxW, (int)worldPxH, DARKGRAY);
 
-        // 画蛇 (修复后的循环)
-        for (size_t i = 0; i < snake.size(); i++) {
-            Color c = (i == 0) ? LIME : GREEN; // 蛇头颜色区分
-            DrawRectangle(snake[i].x * GRID_SIZE + 1, snake[i].y * GRID_SIZE + 1, GRID_SIZE - 2, GRID_SIZE - 2, c);
-        }
+            // 画蛇：按直线段合并，绘制次数只与拐弯数有关，与蛇长无关
+            DrawSnakeRuns(alpha, x0, y0, x1, y1);
+        EndMode2D();
 
         DrawText(TextFormat("SCORE: %d", score), 20, 20, 20, DARKGRAY);
+        if (bigWorld) {
+            DrawText(TextFormat("WORLD %dx%d  POS %d,%d  CHUNKS %d (%d KB)", worldWidth, worldHeight, snake[0].x, snake[0].y,
+                                (int)chunks.size(), (int)(chunks.size() * sizeof(Chunk) / 1024)), 20, 45, 15, GRAY);
+        }
 
         if (isGameOver) {
             DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.8f));
@@ -107,7 +666,48 @@ void UpdateDrawFrame() {
     EndDrawing();
 }
 
-int main() {
+#if !defined(PLATFORM_WEB)
+// 大世界食物自检：蛇头沿折线走过好几屏，每一步都要求当前一屏内有 BIG_WORLD_FOOD 个食物，
+// 且食物总数和块数不随走过的路程增长。用法：snake_game --food-walk，不通过返回非零
+bool RunFoodWalkCheck() {
+    const int LEG = GRID_WIDTH * 3;    // 每段三屏宽
+    const SnakeNode legs[] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, 1 }, { 1, 0 } };
+    bool wasBig = bigWorld;
+    bigWorld = true;
+    ResetGame();
+    int steps = 0, minInView = BIG_WORLD_FOOD, maxFoods = 0, maxChunks = 0;
+    for (const SnakeNode& leg : legs) {
+        speed = { (float)leg.x, (float)leg.y };
+        for (int i = 0; i < LEG && !isGameOver; i++) {
+            StepSnake();
+            steps++;
+            minInView = std::min(minInView, RefillFood());
+            maxFoods = std::max(maxFoods, (int)foods.size());
+            maxChunks = std::max(maxChunks, (int)chunks.size());
+        }
+    }
+    SnakeNode start = { BIG_WORLD_SIZE / 2, BIG_WORLD_SIZE / 2 };
+    printf("walked %d steps to %+d,%+d cells (score %d): min food in view %d / %d, max food on map %d, max chunks %d\n",
+           steps, snake[0].x - start.x, snake[0].y - start.y, score, minInView, BIG_WORLD_FOOD, maxFoods, maxChunks);
+    // 回收范围是一屏外扩 FOOD_KEEP_MARGIN 格，食物密度不超过一屏的目标数，块数也就被这块面积封住
+    const int keepW = GRID_WIDTH + 2 * FOOD_KEEP_MARGIN, keepH = GRID_HEIGHT + 2 * FOOD_KEEP_MARGIN;
+    bool ok = !isGameOver && minInView == BIG_WORLD_FOOD &&
+              maxFoods <= BIG_WORLD_FOOD * (keepW * keepH) / (GRID_WIDTH * GRID_HEIGHT) + BIG_WORLD_FOOD &&
+              maxChunks <= (keepW / CHUNK_SIZE + 2) * (keepH / CHUNK_SIZE + 2) + (int)snake.size();
+    printf("%s\n", ok ? "ok" : "FAILED");
+    bigWorld = wasBig;
+    return ok;
+}
+#endif
+
+int main(int argc, char** argv) {
+#if !defined(PLATFORM_WEB)
+    if (argc > 1 && strcmp(argv[1], "--food-walk") == 0) return RunFoodWalkCheck() ? 0 : 1;
+    if (argc > 1 && strcmp(argv[1], "--arena-bench") == 0) {
+        RunArenaBenchmark(argc > 2 ? atoi(argv[2]) : 0);
+        return 0;
+    }
+#endif
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "TinyPulse - Snake");
     ResetGame();
 #if defined(PLATFORM_WEB)